@@ -12,9 +12,47 @@
 // 3) Accumulators: totals, averages, earnings
 // 4) Tracking largest values: update max1/max2
 // 5) Nested loops for patterns (hollow square)
+// 6) Batch mode (./a.out FILE, or - for stdin): same EX16-EX20 input without prompts,
+//    read through FastInput (mmap / big blocks + SIMD line split + from_chars)
+// 7) Columnar payroll (EX19 at scale): branch-free overtime, exact cents, SIMD + threads
+//    (./a.out --bench compares it with the scalar EX19 loop)
+// 8) Columnar credit screening (EX17 at scale): SIMD balance + compare mask, over-limit
+//    accounts compacted into an exception list, written as CSV or binary records
+//    (./a.out FILE OUT.csv | OUT.bin)
+// 9) Fleet MPG (EX16 for many vehicles): per-vehicle running sums in an open-addressing
+//    hash table, mergeable shard states, snapshots while ingesting (./a.out --fleet FILE)
+// 10) Top-K (EX20 generalised): bounded min-heap + SIMD "beats the K-th?" prefilter,
+//     per-thread heaps merged at the end; K = 2 is EX20 (./a.out --topk K FILE)
 
 #include <iostream>
 #include <limits>
+#include <cmath>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#include <cstdint>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using std::cin;
 using std::cout;
@@ -29,7 +67,1302 @@ int failInputAndExit() {
     return 1;
 }
 
-int main() {
+/* ============================================================================
+   FastInput: zero-copy line reader + number parser for large input files
+   Why:
+   - cin >> value goes through the iostream/locale machinery for every value
+     and is far too slow for multi-GB input files.
+   How:
+   - Regular file: mmap the whole file (no copy; the kernel pages it in).
+   - stdin / pipes (or if mmap fails): fread 1 MB blocks; a line cut at the
+     end of a block is moved to the front before the next fread.
+   - Lines are split by searching '\n' 16/32 bytes at a time (SSE2/AVX2).
+   - Numbers are parsed with std::from_chars: no locale, no allocation.
+     from_chars also accepts "inf" and "nan"; cin does not, so those are
+     bad tokens here too.
+   Token rules (same input as the interactive prompts):
+   - numbers separated by spaces/tabs/newlines ("\r\n" files are fine)
+   - readDouble/readInt return false at end of input OR on a bad token
+     (or a read error); failed() tells the two apart (like cin.fail() vs
+     cin.eof()).
+   ========================================================================== */
+class FastInput {
+public:
+    explicit FastInput(const char* path)
+        : file_(nullptr), mapped_(nullptr), mappedSize_(0),
+          cur_(nullptr), end_(nullptr), tokCur_(nullptr), tokEnd_(nullptr),
+          eof_(false), failed_(false) {
+        if (std::strcmp(path, "-") == 0) {
+            file_ = stdin;
+        } else {
+#if defined(__unix__) || defined(__APPLE__)
+            int fd = open(path, O_RDONLY);
+            struct stat st;
+            if (fd >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+                void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+                    mapped_ = static_cast<const char*>(p);
+                    mappedSize_ = static_cast<size_t>(st.st_size);
+                    cur_ = mapped_;
+                    end_ = mapped_ + mappedSize_;
+                    eof_ = true;    // nothing more to read: the whole file is visible
+                }
+            }
+            if (fd >= 0) close(fd);
+            if (mapped_ != nullptr) return;
+#endif
+            file_ = std::fopen(path, "rb");
+            if (file_ == nullptr) {
+                failed_ = true;
+                eof_ = true;
+            }
+        }
+        buffer_.resize(kBlockSize);
+        cur_ = end_ = buffer_.data();
+    }
+
+    ~FastInput() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (mapped_ != nullptr) munmap(const_cast<char*>(mapped_), mappedSize_);
+#endif
+        if (file_ != nullptr && file_ != stdin) std::fclose(file_);
+    }
+
+    FastInput(const FastInput&) = delete;
+    FastInput& operator=(const FastInput&) = delete;
+
+    bool failed() const { return failed_; }
+
+    // Next line as [begin, end) without the '\n' (and without a trailing '\r')
+    bool nextLine(const char*& begin, const char*& end) {
+        for (;;) {
+            const char* nl = findNewline(cur_, end_);
+            if (nl != nullptr || (eof_ && cur_ < end_)) {
+                begin = cur_;
+                end = (nl != nullptr) ? nl : end_;
+                cur_ = (nl != nullptr) ? nl + 1 : end_;
+                if (end > begin && end[-1] == '\r') --end;
+                return true;
+            }
+            if (eof_) return false;
+            refill();
+        }
+    }
+
+    bool readDouble(double& value) { return readNumber(value); }
+    bool readInt(long long& value) { return readNumber(value); }
+
+private:
+    static constexpr size_t kBlockSize = size_t(1) << 20;
+
+    std::FILE* file_;
+    const char* mapped_;
+    size_t mappedSize_;
+    std::vector<char> buffer_;
+    const char* cur_;      // unread bytes are [cur_, end_)
+    const char* end_;
+    const char* tokCur_;   // unread part of the current line
+    const char* tokEnd_;
+    bool eof_;
+    bool failed_;
+
+    static const char* findNewline(const char* p, const char* end) {
+#if defined(__AVX2__)
+        const __m256i nl = _mm256_set1_epi8('\n');
+        for (; end - p >= 32; p += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nl)));
+            if (mask != 0) return p + __builtin_ctz(mask);
+        }
+#elif defined(__SSE2__)
+        const __m128i nl = _mm_set1_epi8('\n');
+        for (; end - p >= 16; p += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)));
+            if (mask != 0) return p + __builtin_ctz(mask);
+        }
+#endif
+        for (; p < end; p++) {
+            if (*p == '\n') return p;
+        }
+        return nullptr;
+    }
+
+    // Keep the unfinished line, then append the next block from the file
+    void refill() {
+        size_t keep = static_cast<size_t>(end_ - cur_);
+        if (keep + kBlockSize > buffer_.size()) {
+            // a line longer than the buffer: grow (lines are never split)
+            std::vector<char> bigger(keep + kBlockSize);
+            std::memcpy(bigger.data(), cur_, keep);
+            buffer_.swap(bigger);
+        } else {
+            std::memmove(buffer_.data(), cur_, keep);
+        }
+        size_t got = std::fread(buffer_.data() + keep, 1, buffer_.size() - keep, file_);
+        cur_ = buffer_.data();
+        end_ = cur_ + keep + got;
+        if (got == 0) {
+            eof_ = true;
+            if (std::ferror(file_)) failed_ = true;   // e.g. a directory: a read error, not an empty file
+        }
+    }
+
+    template <typename T>
+    bool readNumber(T& value) {
+        for (;;) {
+            while (tokCur_ < tokEnd_ && (*tokCur_ == ' ' || *tokCur_ == '\t')) tokCur_++;
+            if (tokCur_ < tokEnd_) break;
+            if (!nextLine(tokCur_, tokEnd_)) return false;   // end of input
+        }
+        std::from_chars_result r = std::from_chars(tokCur_, tokEnd_, value);
+        if (r.ec != std::errc() || (r.ptr < tokEnd_ && *r.ptr != ' ' && *r.ptr != '\t')) {
+            failed_ = true;    // not a number (same as cin failing)
+            return false;
+        }
+        if constexpr (std::is_floating_point<T>::value) {
+            if (!std::isfinite(value)) {
+                failed_ = true;
+                return false;
+            }
+        }
+        tokCur_ = r.ptr;
+        return true;
+    }
+};
+
+/* ============================================================================
+   Payroll engine: EX19 gross pay over columns hours[] / rate[]
+   Branch-free overtime (min/max instead of if):
+     40*pay + (hours-40)*pay*1.5  ==  pay * (hours + 0.5 * max(hours - 40, 0))
+   Exact cents:
+   - Doubles cannot hold 12.34 exactly, so pay*hours can land on 1075.0049999
+     instead of a half cent. We first snap the inputs to whole units:
+       hc = round(hours * 100)   (hundredths of an hour)
+       rc = round(rate  * 100)   (cents per hour)
+     then, all in exact integer values:
+       units = 2*hc + max(hc - 4000, 0)       (half-hundredths of an hour)
+       cents = floor((rc * units + 100) / 200)   (round half up)
+   - Every intermediate is an integer below 2^53, so doubles compute it
+     exactly and the SIMD path and the scalar path give identical cents.
+     That needs |hours| <= 1e5 and |rate| <= 1e6 (rc * units <= 3e15);
+     callers check payrollInputInRange first, since past that the int64
+     conversion of rc * units is undefined.
+   - Result column is int64 cents (no rounding left for the caller).
+   ========================================================================== */
+constexpr double kMaxPayrollHours = 1e5;
+constexpr double kMaxPayrollRate = 1e6;
+
+inline bool payrollInputInRange(double hours, double rate) {
+    // false for NaN as well
+    return std::fabs(hours) <= kMaxPayrollHours && std::fabs(rate) <= kMaxPayrollRate;
+}
+
+// The scalar path rounds inline: without SSE4.1 std::nearbyint and std::floor
+// are library calls, which cost more than the whole formula
+inline double roundHalfEven(double x) {
+    // adding 1.5 * 2^52 leaves no fraction bits, so the FPU rounds (to even)
+    double shifted = x + 6755399441055744.0;
+    return shifted - 6755399441055744.0;
+}
+
+inline int64_t grossPayCentsScalar(double hours, double rate) {
+    double hc = roundHalfEven(hours * 100.0);
+    double rc = roundHalfEven(rate * 100.0);
+#if defined(__SSE2__)
+    // maxsd spelled out: GCC turns std::max on doubles into a branch here,
+    // and a branch on hours > 40 mispredicts on real payroll data
+    double overtime = _mm_cvtsd_f64(_mm_max_sd(_mm_set_sd(hc - 4000.0), _mm_setzero_pd()));
+#else
+    double overtime = std::max(hc - 4000.0, 0.0);
+#endif
+    double units = (2.0 * hc) + overtime;
+    // rc * units is an exact integer: divide as int64 (a multiply, not a divsd)
+    int64_t n = static_cast<int64_t>(rc * units) + 100;
+    return (n >= 0) ? n / 200 : -((199 - n) / 200);   // floor(n / 200)
+}
+
+void grossPayCentsRange(const double hours[], const double rate[], int64_t grossCents[],
+                        size_t begin, size_t end) {
+    size_t i = begin;
+#if defined(__AVX2__)
+    const __m256d k100 = _mm256_set1_pd(100.0);
+    const __m256d k200 = _mm256_set1_pd(200.0);
+    const __m256d k4000 = _mm256_set1_pd(4000.0);
+    const __m256d kZero = _mm256_setzero_pd();
+    // 1.5 * 2^52: adding it puts an integral double into the low mantissa
+    // bits, so (bits - bits(magic)) is the int64 value (AVX2 has no cvtpd_epi64)
+    const __m256d kMagic = _mm256_set1_pd(6755399441055744.0);
+    const int kRound = _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC;
+    for (; i + 4 <= end; i += 4) {
+        __m256d hc = _mm256_round_pd(_mm256_mul_pd(_mm256_loadu_pd(hours + i), k100), kRound);
+        __m256d rc = _mm256_round_pd(_mm256_mul_pd(_mm256_loadu_pd(rate + i), k100), kRound);
+        __m256d units = _mm256_add_pd(_mm256_add_pd(hc, hc), _mm256_max_pd(_mm256_sub_pd(hc, k4000), kZero));
+        __m256d cents = _mm256_floor_pd(_mm256_div_pd(_mm256_add_pd(_mm256_mul_pd(rc, units), k100), k200));
+        __m256i bits = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(cents, kMagic)),
+                                        _mm256_castpd_si256(kMagic));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(grossCents + i), bits);
+    }
+#endif
+    for (; i < end; i++) {
+        grossCents[i] = grossPayCentsScalar(hours[i], rate[i]);
+    }
+}
+
+// threadCount 0 = one thread per core; small inputs stay on the caller's thread
+void computeGrossPayCents(const double hours[], const double rate[], int64_t grossCents[],
+                          size_t count, unsigned threadCount = 0) {
+    if (threadCount == 0) {
+        threadCount = std::max(1U, std::thread::hardware_concurrency());
+    }
+    // keep chunks big enough that thread start-up is noise next to the work
+    const size_t kMinChunk = size_t(1) << 16;
+    threadCount = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threadCount, count / kMinChunk)));
+
+    if (threadCount == 1) {
+        grossPayCentsRange(hours, rate, grossCents, 0, count);
+        return;
+    }
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threadCount; t++) {
+        size_t begin = count * t / threadCount;
+        size_t end = count * (t + 1) / threadCount;
+        workers.emplace_back(grossPayCentsRange, hours, rate, grossCents, begin, end);
+    }
+    for (std::thread& w : workers) w.join();
+}
+
+void printCents(int64_t cents) {
+    if (cents < 0) {
+        cout << "-";
+        cents = -cents;
+    }
+    cout << (cents / 100) << "." << ((cents % 100) < 10 ? "0" : "") << (cents % 100);
+}
+
+/* ============================================================================
+   Benchmark: ./a.out --bench
+   - "EX19 loop" is the original branchy double formula (no cent rounding)
+   - the engine is timed single-threaded and on all cores
+   - the SIMD column is checked against grossPayCentsScalar
+   ========================================================================== */
+int benchmarkPayroll() {
+    const size_t kEmployees = size_t(1) << 23;
+    std::vector<double> hours(kEmployees), rate(kEmployees), grossPay(kEmployees);
+    std::vector<int64_t> grossCents(kEmployees);
+
+    std::mt19937_64 rng(19);
+    std::uniform_int_distribution<int> hourDist(0, 6000);    // 0.00 .. 60.00 h
+    std::uniform_int_distribution<int> rateDist(725, 8000);  // $7.25 .. $80.00
+    for (size_t i = 0; i < kEmployees; i++) {
+        hours[i] = hourDist(rng) / 100.0;
+        rate[i] = rateDist(rng) / 100.0;
+    }
+
+    auto timeIt = [kEmployees](auto&& body) {
+        double best = 1e300;
+        for (int round = 0; round < 5; round++) {
+            auto t0 = std::chrono::steady_clock::now();
+            body();
+            auto t1 = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count());
+        }
+        return best / static_cast<double>(kEmployees);
+    };
+
+    double loopNs = timeIt([&]() {
+        for (size_t i = 0; i < kEmployees; i++) {
+            double h = hours[i], pay = rate[i];
+            if (h > 40.0) {
+                grossPay[i] = (40.0 * pay) + ((h - 40.0) * pay * 1.5);
+            } else {
+                grossPay[i] = h * pay;
+            }
+        }
+    });
+    double scalarNs = timeIt([&]() {
+        for (size_t i = 0; i < kEmployees; i++) grossCents[i] = grossPayCentsScalar(hours[i], rate[i]);
+    });
+    double oneThreadNs = timeIt([&]() {
+        computeGrossPayCents(hours.data(), rate.data(), grossCents.data(), kEmployees, 1);
+    });
+    double allThreadsNs = timeIt([&]() {
+        computeGrossPayCents(hours.data(), rate.data(), grossCents.data(), kEmployees);
+    });
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < kEmployees; i++) {
+        if (grossCents[i] != grossPayCentsScalar(hours[i], rate[i])) mismatches++;
+    }
+
+    cout << "Payroll, " << kEmployees << " employees (ns/employee, best of 5):\n";
+    cout << "  EX19 loop (double, branchy) : " << loopNs << "\n";
+    cout << "  exact cents, scalar         : " << scalarNs << "\n";
+    cout << "  exact cents, engine 1 thread: " << oneThreadNs << "\n";
+    cout << "  exact cents, engine all cores: " << allThreadsNs
+         << " (" << std::max(1U, std::thread::hardware_concurrency()) << " threads)\n";
+    cout << "  mismatches vs scalar        : " << mismatches << "\n";
+    return mismatches == 0 ? 0 : 1;
+}
+
+/* ============================================================================
+   Credit screening: EX17 over account columns
+   One pass per account:
+     newBalance = beginningBalance + totalCharges - totalCredits
+     over       = newBalance > creditLimit
+   Over-limit rows are appended to an exception list (stream compaction):
+   - AVX2: 4 accounts per step; movemask gives a 4-bit "over" mask, a 16-entry
+     table turns it into a lane permutation that packs the over-limit lanes to
+     the front, we store all 4 lanes and advance the output by popcount(mask).
+     No branch per account, so the rare over-limit rows cost nothing extra.
+   - Each thread compacts 4096-row blocks into a stack scratch (+4 rows of
+     slack for the full-vector stores) and keeps the hits in its own list;
+     lists are joined in thread order, so the exception list is in input
+     order whatever the thread count.
+   ========================================================================== */
+struct AccountColumns {
+    const int64_t* accountNumber;
+    const double* beginningBalance;
+    const double* totalCharges;
+    const double* totalCredits;
+    const double* creditLimit;
+    size_t count;
+};
+
+struct CreditExceptions {
+    std::vector<int64_t> accountNumber;
+    std::vector<double> newBalance;
+    std::vector<double> creditLimit;
+};
+
+#if defined(__AVX2__)
+// kCompact4[mask]: dword indices that move the set 64-bit lanes of mask to the front
+struct CompactTable4 {
+    __m256i perm[16];
+    CompactTable4() {
+        for (int mask = 0; mask < 16; mask++) {
+            int idx[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+            int out = 0;
+            for (int lane = 0; lane < 4; lane++) {
+                if (mask & (1 << lane)) {
+                    idx[2 * out] = 2 * lane;
+                    idx[2 * out + 1] = 2 * lane + 1;
+                    out++;
+                }
+            }
+            perm[mask] = _mm256_setr_epi32(idx[0], idx[1], idx[2], idx[3], idx[4], idx[5], idx[6], idx[7]);
+        }
+    }
+};
+static const CompactTable4 kCompact4;
+#endif
+
+// Screens rows [begin, end) into out (room for end - begin + 4 rows); returns rows written
+size_t screenCreditRange(const AccountColumns& in, size_t begin, size_t end,
+                         int64_t* outAccount, double* outBalance, double* outLimit) {
+    size_t n = 0;
+    size_t i = begin;
+#if defined(__AVX2__)
+    for (; i + 4 <= end; i += 4) {
+        __m256d limit = _mm256_loadu_pd(in.creditLimit + i);
+        __m256d balance = _mm256_sub_pd(_mm256_add_pd(_mm256_loadu_pd(in.beginningBalance + i),
+                                                      _mm256_loadu_pd(in.totalCharges + i)),
+                                        _mm256_loadu_pd(in.totalCredits + i));
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(balance, limit, _CMP_GT_OQ));
+        __m256i perm = kCompact4.perm[mask];
+        __m256i account = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in.accountNumber + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(outAccount + n),
+                            _mm256_permutevar8x32_epi32(account, perm));
+        _mm256_storeu_pd(outBalance + n, _mm256_castsi256_pd(
+                             _mm256_permutevar8x32_epi32(_mm256_castpd_si256(balance), perm)));
+        _mm256_storeu_pd(outLimit + n, _mm256_castsi256_pd(
+                             _mm256_permutevar8x32_epi32(_mm256_castpd_si256(limit), perm)));
+        n += static_cast<size_t>(__builtin_popcount(static_cast<unsigned>(mask)));
+    }
+#endif
+    for (; i < end; i++) {
+        double balance = in.beginningBalance[i] + in.totalCharges[i] - in.totalCredits[i];
+        // branch-free scalar compaction: always write, advance only when over
+        outAccount[n] = in.accountNumber[i];
+        outBalance[n] = balance;
+        outLimit[n] = in.creditLimit[i];
+        n += (balance > in.creditLimit[i]) ? 1 : 0;
+    }
+    return n;
+}
+
+// Returns the number of over-limit accounts; threadCount 0 = one per core
+size_t screenCreditLimits(const AccountColumns& in, CreditExceptions& out, unsigned threadCount = 0) {
+    if (threadCount == 0) {
+        threadCount = std::max(1U, std::thread::hardware_concurrency());
+    }
+    const size_t kMinChunk = size_t(1) << 16;
+    threadCount = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threadCount, in.count / kMinChunk)));
+
+    std::vector<CreditExceptions> local(threadCount);
+    auto screenChunk = [&](unsigned t) {
+        size_t begin = in.count * t / threadCount;
+        size_t end = in.count * (t + 1) / threadCount;
+        // compact a block at a time into a small cache-resident scratch, then
+        // keep only the hits (sizing for the whole chunk would touch as much
+        // memory as the input itself)
+        const size_t kBlock = 4096;
+        int64_t scratchAccount[kBlock + 4];
+        double scratchBalance[kBlock + 4];
+        double scratchLimit[kBlock + 4];
+        CreditExceptions& mine = local[t];
+        for (size_t blockBegin = begin; blockBegin < end; blockBegin += kBlock) {
+            size_t blockEnd = std::min(end, blockBegin + kBlock);
+            size_t n = screenCreditRange(in, blockBegin, blockEnd, scratchAccount, scratchBalance, scratchLimit);
+            mine.accountNumber.insert(mine.accountNumber.end(), scratchAccount, scratchAccount + n);
+            mine.newBalance.insert(mine.newBalance.end(), scratchBalance, scratchBalance + n);
+            mine.creditLimit.insert(mine.creditLimit.end(), scratchLimit, scratchLimit + n);
+        }
+    };
+    if (threadCount == 1) {
+        screenChunk(0);
+    } else {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threadCount; t++) workers.emplace_back(screenChunk, t);
+        for (std::thread& w : workers) w.join();
+    }
+
+    out.accountNumber.clear();
+    out.newBalance.clear();
+    out.creditLimit.clear();
+    for (const CreditExceptions& part : local) {
+        out.accountNumber.insert(out.accountNumber.end(), part.accountNumber.begin(), part.accountNumber.end());
+        out.newBalance.insert(out.newBalance.end(), part.newBalance.begin(), part.newBalance.end());
+        out.creditLimit.insert(out.creditLimit.end(), part.creditLimit.begin(), part.creditLimit.end());
+    }
+    return out.accountNumber.size();
+}
+
+/* ============================================================================
+   Exception stream output
+   - CSV: header + "account,new_balance,credit_limit" rows (%.2f money)
+   - Binary: fixed 24-byte records {int64 account; double newBalance;
+     double creditLimit} in host byte order, no header; easy to mmap later
+   - Both go through one big stdio buffer instead of cout per row.
+   Returns false on a write error.
+   ========================================================================== */
+bool writeExceptionsCsv(std::FILE* out, const CreditExceptions& ex) {
+    std::vector<char> buffer(size_t(1) << 16);
+    size_t used = static_cast<size_t>(std::snprintf(buffer.data(), buffer.size(), "account,new_balance,credit_limit\n"));
+    for (size_t i = 0; i < ex.accountNumber.size(); i++) {
+        // %.2f of a huge balance is ~310 digits: format, and if the row did not
+        // fit, flush and format it again (a row is far below the buffer size)
+        for (;;) {
+            size_t room = buffer.size() - used;
+            int written = std::snprintf(buffer.data() + used, room, "%lld,%.2f,%.2f\n",
+                                        static_cast<long long>(ex.accountNumber[i]),
+                                        ex.newBalance[i], ex.creditLimit[i]);
+            if (written < 0) return false;
+            if (static_cast<size_t>(written) < room) {
+                used += static_cast<size_t>(written);
+                break;
+            }
+            if (used == 0) return false;
+            if (std::fwrite(buffer.data(), 1, used, out) != used) return false;
+            used = 0;
+        }
+    }
+    return std::fwrite(buffer.data(), 1, used, out) == used;
+}
+
+bool writeExceptionsBinary(std::FILE* out, const CreditExceptions& ex) {
+    struct Record {
+        int64_t accountNumber;
+        double newBalance;
+        double creditLimit;
+    };
+    std::vector<Record> records(ex.accountNumber.size());
+    for (size_t i = 0; i < records.size(); i++) {
+        records[i] = Record{ex.accountNumber[i], ex.newBalance[i], ex.creditLimit[i]};
+    }
+    return std::fwrite(records.data(), sizeof(Record), records.size(), out) == records.size();
+}
+
+/* ============================================================================
+   Benchmark: EX17 loop (one branch per account) vs the screening engine
+   - ~1% of accounts over limit, spread at random
+   ========================================================================== */
+int benchmarkCreditScreening() {
+    const size_t kAccounts = size_t(1) << 23;
+    std::vector<int64_t> account(kAccounts);
+    std::vector<double> beginning(kAccounts), charges(kAccounts), credits(kAccounts), limit(kAccounts);
+
+    std::mt19937_64 rng(17);
+    std::uniform_int_distribution<int> cents(0, 100000);
+    std::uniform_int_distribution<int> percent(0, 99);
+    for (size_t i = 0; i < kAccounts; i++) {
+        account[i] = static_cast<int64_t>(100000 + i);
+        beginning[i] = cents(rng) / 100.0;
+        charges[i] = cents(rng) / 100.0;
+        credits[i] = cents(rng) / 100.0;
+        double balance = beginning[i] + charges[i] - credits[i];
+        limit[i] = (percent(rng) == 0) ? balance - 1.0 : balance + 500.0;
+    }
+    AccountColumns columns{account.data(), beginning.data(), charges.data(), credits.data(), limit.data(), kAccounts};
+
+    auto timeIt = [kAccounts](auto&& body) {
+        double best = 1e300;
+        for (int round = 0; round < 5; round++) {
+            auto t0 = std::chrono::steady_clock::now();
+            body();
+            auto t1 = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count());
+        }
+        return best / static_cast<double>(kAccounts);
+    };
+
+    std::vector<int64_t> loopExceptions;
+    double loopNs = timeIt([&]() {
+        loopExceptions.clear();
+        for (size_t i = 0; i < kAccounts; i++) {
+            double newBalance = beginning[i] + charges[i] - credits[i];
+            if (newBalance > limit[i]) loopExceptions.push_back(account[i]);
+        }
+    });
+    CreditExceptions ex;
+    double oneThreadNs = timeIt([&]() { screenCreditLimits(columns, ex, 1); });
+    double allThreadsNs = timeIt([&]() { screenCreditLimits(columns, ex); });
+
+    bool same = (ex.accountNumber == loopExceptions);
+
+    // CSV rows longer than the old 128-byte flush margin: 1e300 balances
+    CreditExceptions wide;
+    std::string expectedCsv = "account,new_balance,credit_limit\n";
+    for (size_t i = 0; i < 1000; i++) {
+        double balance = (i % 3 == 0) ? 1e300 : 1234.5 + static_cast<double>(i);
+        double creditLimit = (i % 7 == 0) ? -1e300 : 1000.0;
+        wide.accountNumber.push_back(static_cast<int64_t>(100000 + i));
+        wide.newBalance.push_back(balance);
+        wide.creditLimit.push_back(creditLimit);
+        char row[1024];
+        std::snprintf(row, sizeof(row), "%lld,%.2f,%.2f\n", static_cast<long long>(100000 + i), balance, creditLimit);
+        expectedCsv += row;
+    }
+    bool csvSame = false;
+    if (std::FILE* tmp = std::tmpfile()) {
+        if (writeExceptionsCsv(tmp, wide)) {
+            std::string got(expectedCsv.size() + 1, '\0');
+            std::rewind(tmp);
+            got.resize(std::fread(&got[0], 1, got.size(), tmp));
+            csvSame = (got == expectedCsv);
+        }
+        std::fclose(tmp);
+    }
+
+    cout << "Credit screening, " << kAccounts << " accounts, " << ex.accountNumber.size()
+         << " over limit (ns/account, best of 5):\n";
+    cout << "  EX17 loop (branch per account): " << loopNs << "\n";
+    cout << "  engine 1 thread               : " << oneThreadNs << "\n";
+    cout << "  engine all cores              : " << allThreadsNs
+         << " (" << std::max(1U, std::thread::hardware_concurrency()) << " threads)\n";
+    cout << "  same exception list           : " << (same ? "yes" : "NO") << "\n";
+    cout << "  CSV with 300-digit rows       : " << (csvSame ? "yes" : "NO") << "\n";
+    return (same && csvSame) ? 0 : 1;
+}
+
+/* ============================================================================
+   Fleet MPG: EX16 (milesTotal / gallonsTotal) kept per vehicle id
+   Event = one tankful: {vehicleId, gallons, miles, seq}
+   - seq orders events (line number, timestamp, ...); the "last tank" of a
+     vehicle is the one with the largest seq, so merging shards that saw
+     events in a different order still gives the right per-tank answer.
+   FleetMpgTable (one shard, single-threaded):
+   - open addressing, linear probing, power-of-two capacity, max load 1/2
+   - slots are stored inline (no node allocation per vehicle); tanks == 0
+     marks an empty slot because every stored vehicle has at least one tank
+   - merge(other) adds the sums: partial states from shards / threads / files
+     combine in any order into the same totals
+   Queries: VehicleMpg::tankMpg() (last tankful) and overallMpg() (EX16's
+   overall figure); like EX16 they divide without checking for 0 gallons.
+   ========================================================================== */
+struct MpgEvent {
+    uint64_t vehicleId;
+    double gallons;
+    double miles;
+    uint64_t seq;
+};
+
+struct VehicleMpg {
+    uint64_t vehicleId;
+    uint64_t tanks;        // 0 = empty slot
+    double milesTotal;
+    double gallonsTotal;
+    double lastMiles;
+    double lastGallons;
+    uint64_t lastSeq;
+
+    double tankMpg() const { return lastMiles / lastGallons; }
+    double overallMpg() const { return milesTotal / gallonsTotal; }
+};
+
+inline uint64_t mixVehicleId(uint64_t id) {
+    // splitmix64 finaliser: sequential ids spread over all slots
+    id ^= id >> 30;
+    id *= 0xbf58476d1ce4e5b9ULL;
+    id ^= id >> 27;
+    id *= 0x94d049bb133111ebULL;
+    return id ^ (id >> 31);
+}
+
+class FleetMpgTable {
+public:
+    explicit FleetMpgTable(size_t expectedVehicles = 1024) : size_(0) {
+        size_t capacity = 16;
+        while (capacity < 2 * expectedVehicles) capacity *= 2;
+        slots_.assign(capacity, VehicleMpg{});
+    }
+
+    void add(const MpgEvent& e) {
+        VehicleMpg& v = slotFor(e.vehicleId);
+        v.milesTotal += e.miles;
+        v.gallonsTotal += e.gallons;
+        if (v.tanks == 0 || e.seq >= v.lastSeq) {
+            v.lastMiles = e.miles;
+            v.lastGallons = e.gallons;
+            v.lastSeq = e.seq;
+        }
+        v.tanks++;
+    }
+
+    // fold one vehicle's partial state into this table
+    void mergeVehicle(const VehicleMpg& o) {
+        VehicleMpg& v = slotFor(o.vehicleId);
+        v.milesTotal += o.milesTotal;
+        v.gallonsTotal += o.gallonsTotal;
+        if (v.tanks == 0 || o.lastSeq >= v.lastSeq) {
+            v.lastMiles = o.lastMiles;
+            v.lastGallons = o.lastGallons;
+            v.lastSeq = o.lastSeq;
+        }
+        v.tanks += o.tanks;
+    }
+
+    void merge(const FleetMpgTable& other) {
+        other.forEach([this](const VehicleMpg& o) { mergeVehicle(o); });
+    }
+
+    // nullptr if the vehicle has no tankful yet
+    const VehicleMpg* find(uint64_t vehicleId) const {
+        size_t mask = slots_.size() - 1;
+        for (size_t i = mixVehicleId(vehicleId) & mask;; i = (i + 1) & mask) {
+            const VehicleMpg& v = slots_[i];
+            if (v.tanks == 0) return nullptr;
+            if (v.vehicleId == vehicleId) return &v;
+        }
+    }
+
+    size_t vehicleCount() const { return size_; }
+
+    // Fleet-wide EX16 numbers
+    void totals(uint64_t& tanks, double& milesTotal, double& gallonsTotal) const {
+        tanks = 0;
+        milesTotal = gallonsTotal = 0.0;
+        for (const VehicleMpg& v : slots_) {
+            tanks += v.tanks;
+            milesTotal += v.milesTotal;
+            gallonsTotal += v.gallonsTotal;
+        }
+    }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const VehicleMpg& v : slots_) {
+            if (v.tanks != 0) fn(v);
+        }
+    }
+
+private:
+    std::vector<VehicleMpg> slots_;
+    size_t size_;
+
+    VehicleMpg& slotFor(uint64_t vehicleId) {
+        if (2 * (size_ + 1) > slots_.size()) grow();
+        size_t mask = slots_.size() - 1;
+        for (size_t i = mixVehicleId(vehicleId) & mask;; i = (i + 1) & mask) {
+            VehicleMpg& v = slots_[i];
+            if (v.tanks == 0) {
+                v.vehicleId = vehicleId;
+                size_++;
+                return v;    // caller fills the sums and sets tanks
+            }
+            if (v.vehicleId == vehicleId) return v;
+        }
+    }
+
+    void grow() {
+        std::vector<VehicleMpg> old(slots_.size() * 2, VehicleMpg{});
+        old.swap(slots_);
+        size_t mask = slots_.size() - 1;
+        for (const VehicleMpg& v : old) {
+            if (v.tanks == 0) continue;
+            size_t i = mixVehicleId(v.vehicleId) & mask;
+            while (slots_[i].tanks != 0) i = (i + 1) & mask;
+            slots_[i] = v;
+        }
+    }
+};
+
+/* ============================================================================
+   FleetMpgAggregator: many ingest threads + snapshots, no global stop
+   - State is split into shards by the high bits of the id hash; each shard
+     is a FleetMpgTable with its own mutex.
+   - ingest() groups a batch by shard first, then takes each shard lock once
+     per batch (not once per event).
+   - snapshot() copies one shard at a time under that shard's lock and merges
+     the copies: ingestion into every other shard keeps running. Each shard is
+     internally consistent; the snapshot as a whole is "some point during the
+     call", which is what a live dashboard / checkpoint needs.
+   ========================================================================== */
+class FleetMpgAggregator {
+public:
+    explicit FleetMpgAggregator(unsigned shardBits = 6) : shardBits_(shardBits) {
+        for (size_t i = 0; i < (size_t(1) << shardBits_); i++) {
+            shards_.push_back(std::unique_ptr<Shard>(new Shard()));
+        }
+    }
+
+    void ingest(const MpgEvent events[], size_t count) {
+        // counting sort by shard: one scratch array instead of a vector per shard
+        std::vector<size_t> start(shards_.size() + 1, 0);
+        std::vector<uint32_t> shardOfEvent(count);
+        for (size_t i = 0; i < count; i++) {
+            shardOfEvent[i] = static_cast<uint32_t>(shardOf(events[i].vehicleId));
+            start[shardOfEvent[i] + 1]++;
+        }
+        for (size_t s = 0; s < shards_.size(); s++) start[s + 1] += start[s];
+        std::vector<MpgEvent> sorted(count);
+        std::vector<size_t> fill(start.begin(), start.end() - 1);
+        for (size_t i = 0; i < count; i++) sorted[fill[shardOfEvent[i]]++] = events[i];
+
+        for (size_t s = 0; s < shards_.size(); s++) {
+            if (start[s] == start[s + 1]) continue;
+            std::lock_guard<std::mutex> lock(shards_[s]->mutex);
+            for (size_t i = start[s]; i < start[s + 1]; i++) shards_[s]->table.add(sorted[i]);
+        }
+    }
+
+    // merge a partial state built elsewhere (another process, file, thread)
+    void merge(const FleetMpgTable& partial) {
+        std::vector<std::vector<VehicleMpg>> byShard(shards_.size());
+        partial.forEach([&](const VehicleMpg& v) { byShard[shardOf(v.vehicleId)].push_back(v); });
+        for (size_t s = 0; s < shards_.size(); s++) {
+            if (byShard[s].empty()) continue;
+            std::lock_guard<std::mutex> lock(shards_[s]->mutex);
+            for (const VehicleMpg& v : byShard[s]) shards_[s]->table.mergeVehicle(v);
+        }
+    }
+
+    FleetMpgTable snapshot() const {
+        // copy under the lock (a memcpy-speed vector copy), merge outside it
+        std::vector<FleetMpgTable> copies;
+        size_t vehicles = 0;
+        for (const std::unique_ptr<Shard>& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            copies.push_back(shard->table);
+            vehicles += copies.back().vehicleCount();
+        }
+        FleetMpgTable result(vehicles);
+        for (const FleetMpgTable& copy : copies) result.merge(copy);
+        return result;
+    }
+
+private:
+    struct Shard {
+        mutable std::mutex mutex;
+        FleetMpgTable table;
+    };
+    unsigned shardBits_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    size_t shardOf(uint64_t vehicleId) const {
+        return shardBits_ == 0 ? 0 : static_cast<size_t>(mixVehicleId(vehicleId) >> (64 - shardBits_));
+    }
+};
+
+/* ============================================================================
+   Fleet mode: ./a.out --fleet FILE
+   - one tankful per line: vehicleId gallons miles (until -1 or end of file)
+   - seq = position in the file, so "last tank" means the latest line
+   ========================================================================== */
+int runFleet(const char* path) {
+    FastInput in(path);
+    if (in.failed()) {
+        cout << "Cannot open " << path << "\n";
+        return 1;
+    }
+    FleetMpgAggregator fleet;
+    std::vector<MpgEvent> batch;
+    const size_t kBatch = 4096;
+    uint64_t seq = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    while (true) {
+        long long vehicleId = 0;
+        double gallons = 0.0, miles = 0.0;
+        if (!in.readInt(vehicleId) || vehicleId == -1) break;
+        if (!in.readDouble(gallons) || !in.readDouble(miles)) return failInputAndExit();
+        batch.push_back(MpgEvent{static_cast<uint64_t>(vehicleId), gallons, miles, seq++});
+        if (batch.size() == kBatch) {
+            fleet.ingest(batch.data(), batch.size());
+            batch.clear();
+        }
+    }
+    if (in.failed()) return failInputAndExit();
+    fleet.ingest(batch.data(), batch.size());
+    auto t1 = std::chrono::steady_clock::now();
+
+    FleetMpgTable state = fleet.snapshot();
+    uint64_t tanks = 0;
+    double milesTotal = 0.0, gallonsTotal = 0.0;
+    state.totals(tanks, milesTotal, gallonsTotal);
+    double secs = std::chrono::duration<double>(t1 - t0).count();
+
+    cout << "EX16 Fleet: " << state.vehicleCount() << " vehicles, " << tanks << " tanks\n";
+    cout << "EX16 Fleet overall MPG: ";
+    if (gallonsTotal > 0.0) cout << (milesTotal / gallonsTotal) << "\n";
+    else cout << "N/A\n";
+    size_t shown = 0;
+    state.forEach([&](const VehicleMpg& v) {
+        if (shown++ < 5) {
+            cout << "EX16 Vehicle " << v.vehicleId << ": tanks " << v.tanks << ", last tank MPG "
+                 << v.tankMpg() << ", overall MPG " << v.overallMpg() << "\n";
+        }
+    });
+    cout << "EX16 Ingest: " << (secs > 0.0 ? seq / secs / 1e6 : 0.0) << " M events/s\n";
+    return 0;
+}
+
+/* ============================================================================
+   Benchmark: fleet ingestion with a live snapshot reader
+   - every core ingests its own slice of events in 4096-event batches
+   - one extra thread keeps taking snapshots until ingestion finishes
+   - checks the final snapshot against the event count and per-thread
+     FleetMpgTable partials merged afterwards (the mergeable-state path)
+   ========================================================================== */
+int benchmarkFleet() {
+    const size_t kVehicles = size_t(1) << 20;
+    const size_t kEvents = size_t(1) << 24;
+    std::vector<MpgEvent> events(kEvents);
+    std::mt19937_64 rng(16);
+    for (size_t i = 0; i < kEvents; i++) {
+        double gallons = 5.0 + static_cast<double>(rng() % 1000) / 100.0;
+        events[i] = MpgEvent{rng() % kVehicles, gallons, gallons * (20.0 + static_cast<double>(rng() % 20)), i};
+    }
+
+    unsigned threadCount = std::max(1U, std::thread::hardware_concurrency());
+    FleetMpgAggregator fleet;
+    std::vector<FleetMpgTable> partials(threadCount, FleetMpgTable(kVehicles / threadCount));
+    std::atomic<bool> done(false);
+    size_t snapshots = 0;
+    double snapshotMs = 0.0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::thread reader([&]() {
+        while (!done.load()) {
+            auto s0 = std::chrono::steady_clock::now();
+            FleetMpgTable view = fleet.snapshot();
+            auto s1 = std::chrono::steady_clock::now();
+            snapshotMs += std::chrono::duration<double, std::milli>(s1 - s0).count();
+            snapshots++;
+        }
+    });
+    std::vector<std::thread> writers;
+    for (unsigned t = 0; t < threadCount; t++) {
+        writers.emplace_back([&, t]() {
+            size_t begin = kEvents * t / threadCount;
+            size_t end = kEvents * (t + 1) / threadCount;
+            for (size_t i = begin; i < end; i += 4096) {
+                fleet.ingest(events.data() + i, std::min<size_t>(4096, end - i));
+            }
+        });
+    }
+    for (std::thread& w : writers) w.join();
+    auto t1 = std::chrono::steady_clock::now();
+    done.store(true);
+    reader.join();
+
+    // the same events as independent partial states, merged at the end
+    for (unsigned t = 0; t < threadCount; t++) {
+        for (size_t i = kEvents * t / threadCount; i < kEvents * (t + 1) / threadCount; i++) {
+            partials[t].add(events[i]);
+        }
+    }
+    FleetMpgTable merged;
+    for (const FleetMpgTable& part : partials) merged.merge(part);
+
+    FleetMpgTable live = fleet.snapshot();
+    uint64_t liveTanks = 0, mergedTanks = 0;
+    double liveMiles = 0.0, liveGallons = 0.0, mergedMiles = 0.0, mergedGallons = 0.0;
+    live.totals(liveTanks, liveMiles, liveGallons);
+    merged.totals(mergedTanks, mergedMiles, mergedGallons);
+    const VehicleMpg* a = live.find(events.back().vehicleId);
+    const VehicleMpg* b = merged.find(events.back().vehicleId);
+    bool ok = liveTanks == kEvents && mergedTanks == kEvents && live.vehicleCount() == merged.vehicleCount() &&
+              a != nullptr && b != nullptr && a->tanks == b->tanks && a->lastSeq == kEvents - 1 &&
+              b->lastSeq == kEvents - 1;
+
+    double secs = std::chrono::duration<double>(t1 - t0).count();
+    cout << "Fleet MPG, " << kEvents << " events over " << live.vehicleCount() << " vehicles:\n";
+    cout << "  ingest, " << threadCount << " writer thread(s)  : " << (kEvents / secs / 1e6) << " M events/s\n";
+    cout << "  snapshots during ingest      : " << snapshots << " (avg "
+         << (snapshots ? snapshotMs / snapshots : 0.0) << " ms)\n";
+    cout << "  fleet MPG live / merged      : " << (liveMiles / liveGallons) << " / "
+         << (mergedMiles / mergedGallons) << "\n";
+    cout << "  state consistent             : " << (ok ? "yes" : "NO") << "\n";
+    return ok ? 0 : 1;
+}
+
+/* ============================================================================
+   TopK: the K largest values of a stream (EX20 is K = 2)
+   Bounded min-heap:
+   - heap_ holds at most K values, smallest on top (heap_.front()).
+   - once full, a new value only matters if it beats the K-th largest
+     (> heap_.front()); then it replaces the top. Equal values are kept the
+     way EX20 keeps them: 5, 5 gives max1 = 5 and max2 = 5.
+   SIMD prefilter (pushBatch):
+   - for big streams almost every value loses to the K-th largest, so the
+     batch path compares 8 values at a time against the threshold and only
+     walks the lanes that beat it; the threshold vector is refreshed after
+     every accepted value.
+   Parallel (topKParallel): one TopK per thread over its chunk, then merge()
+   the partial heaps; the result is the same multiset as a single pass.
+   ========================================================================== */
+class TopK {
+public:
+    explicit TopK(size_t k) : k_(k) { heap_.reserve(k); }
+
+    // value a new element must beat once the heap is full
+    double threshold() const {
+        return (heap_.size() < k_ || k_ == 0) ? -std::numeric_limits<double>::infinity() : heap_.front();
+    }
+
+    void push(double value) {
+        // NaN is never ranked (it would break the heap order); any other
+        // value, -infinity included, is taken while the heap is not full
+        if (k_ == 0 || std::isnan(value)) return;
+        if (heap_.size() < k_) {
+            heap_.push_back(value);
+            std::push_heap(heap_.begin(), heap_.end(), std::greater<double>());
+        } else if (value > heap_.front()) {
+            std::pop_heap(heap_.begin(), heap_.end(), std::greater<double>());
+            heap_.back() = value;
+            std::push_heap(heap_.begin(), heap_.end(), std::greater<double>());
+        }
+    }
+
+    void pushBatch(const double values[], size_t count) {
+        if (k_ == 0) return;
+        size_t i = 0;
+        // fill phase: every value is accepted until the heap is full
+        for (; i < count && heap_.size() < k_; i++) push(values[i]);
+#if defined(__AVX2__)
+        __m256d limit = _mm256_set1_pd(threshold());
+        for (; i + 8 <= count; i += 8) {
+            __m256d a = _mm256_loadu_pd(values + i);
+            __m256d b = _mm256_loadu_pd(values + i + 4);
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(a, limit, _CMP_GT_OQ))) |
+                            (static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(b, limit, _CMP_GT_OQ))) << 4);
+            if (mask == 0) continue;
+            while (mask != 0) {
+                push(values[i + static_cast<size_t>(__builtin_ctz(mask))]);
+                mask &= mask - 1;
+            }
+            limit = _mm256_set1_pd(threshold());
+        }
+#elif defined(__SSE2__)
+        __m128d limit = _mm_set1_pd(threshold());
+        for (; i + 4 <= count; i += 4) {
+            unsigned mask = static_cast<unsigned>(_mm_movemask_pd(_mm_cmpgt_pd(_mm_loadu_pd(values + i), limit))) |
+                            (static_cast<unsigned>(_mm_movemask_pd(_mm_cmpgt_pd(_mm_loadu_pd(values + i + 2), limit))) << 2);
+            if (mask == 0) continue;
+            while (mask != 0) {
+                push(values[i + static_cast<size_t>(__builtin_ctz(mask))]);
+                mask &= mask - 1;
+            }
+            limit = _mm_set1_pd(threshold());
+        }
+#endif
+        for (; i < count; i++) push(values[i]);
+    }
+
+    void merge(const TopK& other) {
+        for (double v : other.heap_) push(v);
+    }
+
+    size_t size() const { return heap_.size(); }
+
+    // largest first (max1, max2, ...)
+    std::vector<double> sorted() const {
+        std::vector<double> out(heap_);
+        std::sort(out.begin(), out.end(), std::greater<double>());
+        return out;
+    }
+
+private:
+    size_t k_;
+    std::vector<double> heap_;
+};
+
+TopK topKParallel(const double values[], size_t count, size_t k, unsigned threadCount = 0) {
+    if (threadCount == 0) {
+        threadCount = std::max(1U, std::thread::hardware_concurrency());
+    }
+    const size_t kMinChunk = size_t(1) << 16;
+    threadCount = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threadCount, count / kMinChunk)));
+
+    std::vector<TopK> partial(threadCount, TopK(k));
+    auto selectChunk = [&](unsigned t) {
+        size_t begin = count * t / threadCount;
+        size_t end = count * (t + 1) / threadCount;
+        partial[t].pushBatch(values + begin, end - begin);
+    };
+    if (threadCount == 1) {
+        selectChunk(0);
+    } else {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threadCount; t++) workers.emplace_back(selectChunk, t);
+        for (std::thread& w : workers) w.join();
+    }
+    for (unsigned t = 1; t < threadCount; t++) partial[0].merge(partial[t]);
+    return partial[0];
+}
+
+/* ============================================================================
+   Top-K mode: ./a.out --topk K FILE
+   - every number in the file (until -1 or end of file), K largest printed
+   ========================================================================== */
+int runTopK(const char* kText, const char* path) {
+    size_t k = 0;
+    std::from_chars_result r = std::from_chars(kText, kText + std::strlen(kText), k);
+    if (r.ec != std::errc() || *r.ptr != '\0') return failInputAndExit();
+    FastInput in(path);
+    if (in.failed()) {
+        cout << "Cannot open " << path << "\n";
+        return 1;
+    }
+    std::vector<double> values;
+    double n = 0.0;
+    while (in.readDouble(n) && n != -1.0) values.push_back(n);
+    if (in.failed()) return failInputAndExit();
+
+    TopK top = topKParallel(values.data(), values.size(), k);
+    cout << "EX20 Top " << k << " of " << values.size() << " numbers:";
+    for (double v : top.sorted()) cout << " " << v;
+    cout << "\n";
+    return 0;
+}
+
+/* ============================================================================
+   Benchmark: top-1000 of 2^25 random doubles
+   - plain heap push per value vs SIMD prefilter vs all cores
+   - std::nth_element on a copy as the "sort it" reference
+   ========================================================================== */
+int benchmarkTopK() {
+    const size_t kValues = size_t(1) << 25;
+    const size_t kTop = 1000;
+    std::vector<double> values(kValues);
+    std::mt19937_64 rng(20);
+    std::uniform_real_distribution<double> dist(0.0, 1e6);
+    for (double& v : values) v = dist(rng);
+
+    auto timeIt = [kValues](auto&& body) {
+        double best = 1e300;
+        for (int round = 0; round < 3; round++) {
+            auto t0 = std::chrono::steady_clock::now();
+            body();
+            auto t1 = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count());
+        }
+        return best / static_cast<double>(kValues);
+    };
+
+    std::vector<double> reference;
+    double nthNs = timeIt([&]() {
+        std::vector<double> copy(values);
+        std::nth_element(copy.begin(), copy.begin() + kTop, copy.end(), std::greater<double>());
+        reference.assign(copy.begin(), copy.begin() + kTop);
+        std::sort(reference.begin(), reference.end(), std::greater<double>());
+    });
+    std::vector<double> plain, batch, parallel;
+    double plainNs = timeIt([&]() {
+        TopK top(kTop);
+        for (double v : values) top.push(v);
+        plain = top.sorted();
+    });
+    double batchNs = timeIt([&]() {
+        TopK top(kTop);
+        top.pushBatch(values.data(), values.size());
+        batch = top.sorted();
+    });
+    double parallelNs = timeIt([&]() { parallel = topKParallel(values.data(), values.size(), kTop).sorted(); });
+
+    bool same = (plain == reference) && (batch == reference) && (parallel == reference);
+    cout << "Top-" << kTop << " of " << kValues << " doubles (ns/value, best of 3):\n";
+    cout << "  nth_element on a copy     : " << nthNs << "\n";
+    cout << "  heap, push per value      : " << plainNs << "\n";
+    cout << "  heap + SIMD prefilter     : " << batchNs << "\n";
+    cout << "  prefilter, all cores      : " << parallelNs
+         << " (" << std::max(1U, std::thread::hardware_concurrency()) << " threads)\n";
+    cout << "  same result               : " << (same ? "yes" : "NO") << "\n";
+    return same ? 0 : 1;
+}
+
+/* ============================================================================
+   Batch mode: EX16-EX20 from a file, no prompts
+   - Input order is exactly what the interactive prompts ask for, so the same
+     data file can be typed or piped: EX16 pairs ... -1, EX17 5-tuples ... -1,
+     EX18 sales ... -1, EX19 pairs ... -1, EX20 up to 10 numbers (or -1).
+   - ./a.out FILE EXCEPTIONS.csv (or any other name = binary records) sends
+     the EX17 over-limit list to that file instead of the console.
+   - Per-record lines would dominate the run time on big files, so batch mode
+     prints one summary per exercise (EX17 still lists every exceeded account).
+   - EX28 (drawing) is interactive only.
+   ========================================================================== */
+int runBatch(const char* path, const char* exceptionsPath) {
+    constexpr double kSentinel = -1.0;
+    FastInput in(path);
+    if (in.failed()) {
+        cout << "Cannot open " << path << "\n";
+        return 1;
+    }
+    // a bad token, or the input ending before a -1 sentinel: both are
+    // errors, like cin failing at the interactive prompts
+    auto fail = [&in]() {
+        if (!in.failed()) cout << "Input ended before the -1 sentinel.\n";
+        return failInputAndExit();
+    };
+
+    // EX16
+    double milesTotal = 0.0, gallonsTotal = 0.0;
+    long long tanks = 0;
+    while (true) {
+        double gallons = 0.0, miles = 0.0;
+        if (!in.readDouble(gallons)) return fail();
+        if (gallons == kSentinel) break;
+        if (!in.readDouble(miles)) return fail();
+        if (miles == kSentinel) break;
+        milesTotal += miles;
+        gallonsTotal += gallons;
+        tanks++;
+    }
+    cout << "EX16 Tanks: " << tanks << ", overall MPG: ";
+    if (gallonsTotal > 0.0) cout << (milesTotal / gallonsTotal) << "\n";
+    else cout << "N/A\n";
+
+    // EX17: gather the account columns, screen them, then emit the exceptions
+    std::vector<int64_t> accountColumn;
+    std::vector<double> beginningColumn, chargesColumn, creditsColumn, limitColumn;
+    while (true) {
+        long long accountNumber = 0;
+        double beginningBalance = 0.0, totalCharges = 0.0, totalCredits = 0.0, creditLimit = 0.0;
+        if (!in.readInt(accountNumber)) return fail();
+        if (accountNumber == static_cast<long long>(kSentinel)) break;
+        if (!in.readDouble(beginningBalance) || !in.readDouble(totalCharges) ||
+            !in.readDouble(totalCredits) || !in.readDouble(creditLimit)) {
+            return failInputAndExit();
+        }
+        accountColumn.push_back(accountNumber);
+        beginningColumn.push_back(beginningBalance);
+        chargesColumn.push_back(totalCharges);
+        creditsColumn.push_back(totalCredits);
+        limitColumn.push_back(creditLimit);
+    }
+    AccountColumns accounts{accountColumn.data(), beginningColumn.data(), chargesColumn.data(),
+                            creditsColumn.data(), limitColumn.data(), accountColumn.size()};
+    CreditExceptions exceptions;
+    screenCreditLimits(accounts, exceptions);
+    if (exceptionsPath != nullptr) {
+        size_t pathLen = std::strlen(exceptionsPath);
+        bool csv = pathLen >= 4 && std::strcmp(exceptionsPath + pathLen - 4, ".csv") == 0;
+        std::FILE* out = std::fopen(exceptionsPath, csv ? "w" : "wb");
+        bool written = (out != nullptr) &&
+                       (csv ? writeExceptionsCsv(out, exceptions) : writeExceptionsBinary(out, exceptions));
+        if (out != nullptr && std::fclose(out) != 0) written = false;
+        if (!written) {
+            cout << "Cannot write " << exceptionsPath << "\n";
+            return 1;
+        }
+    } else {
+        for (size_t i = 0; i < exceptions.accountNumber.size(); i++) {
+            cout << "EX17 Account " << exceptions.accountNumber[i] << " exceeded: balance "
+                 << exceptions.newBalance[i] << " > limit " << exceptions.creditLimit[i] << "\n";
+        }
+    }
+    cout << "EX17 Accounts: " << accounts.count << ", over limit: " << exceptions.accountNumber.size() << "\n";
+
+    // EX18
+    long long salespeople = 0;
+    double earningsTotal = 0.0;
+    while (true) {
+        double sales = 0.0;
+        if (!in.readDouble(sales)) return fail();
+        if (sales == kSentinel) break;
+        earningsTotal += 200.0 + (0.09 * sales);
+        salespeople++;
+    }
+    cout << "EX18 Salespeople: " << salespeople << ", total earnings: " << earningsTotal << "\n";
+
+    // EX19: gather the columns, then run the payroll engine over them
+    std::vector<double> hoursColumn, rateColumn;
+    while (true) {
+        double hours = 0.0, pay = 0.0;
+        if (!in.readDouble(hours)) return fail();
+        if (hours == kSentinel) break;
+        if (!in.readDouble(pay)) return fail();
+        if (!payrollInputInRange(hours, pay)) return failInputAndExit();
+        hoursColumn.push_back(hours);
+        rateColumn.push_back(pay);
+    }
+    std::vector<int64_t> grossCents(hoursColumn.size());
+    computeGrossPayCents(hoursColumn.data(), rateColumn.data(), grossCents.data(), grossCents.size());
+    int64_t grossTotal = 0;
+    for (int64_t cents : grossCents) grossTotal += cents;
+    cout << "EX19 Employees: " << grossCents.size() << ", total gross pay: ";
+    printCents(grossTotal);
+    cout << "\n";
+
+    // EX20: the two-largest tracker is TopK with K = 2
+    TopK twoLargest(2);
+    for (int count = 1; count <= 10; count++) {
+        double n = 0.0;
+        if (!in.readDouble(n)) return fail();
+        if (n == kSentinel) break;
+        twoLargest.push(n);
+    }
+    std::vector<double> largest = twoLargest.sorted();
+    if (largest.size() == 2) {
+        cout << "EX20 Two largest numbers: " << largest[0] << " and " << largest[1] << "\n";
+    } else if (largest.size() == 1) {
+        cout << "EX20 Only one number entered: " << largest[0] << "\n";
+    } else {
+        cout << "EX20 No valid numbers entered.\n";
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+        int payrollStatus = benchmarkPayroll();
+        int creditStatus = benchmarkCreditScreening();
+        int fleetStatus = benchmarkFleet();
+        int topKStatus = benchmarkTopK();
+        return (payrollStatus | creditStatus | fleetStatus | topKStatus) != 0 ? 1 : 0;
+    }
+    if (argc > 3 && std::strcmp(argv[1], "--topk") == 0) {
+        return runTopK(argv[2], argv[3]);
+    }
+    if (argc > 2 && std::strcmp(argv[1], "--fleet") == 0) {
+        return runFleet(argv[2]);
+    }
+    if (argc > 1) {
+        return runBatch(argv[1], (argc > 2) ? argv[2] : nullptr);
+    }
 
     constexpr double kSentinel = -1.0;
 
@@ -5,9 +5,41 @@
 // - Search "EX" to jump to a topic.
 // - Each EX block demonstrates one concept with a minimal example.
 // - Functions above main are reusable helpers used by multiple exercises.
+// - Batch mode: ./a.out FILE (or - for stdin) runs EX10 + EX15 on the same input
+//   without prompts, read through FastInput (mmap + SIMD line split + from_chars).
+// - Bulk bucketing (Helper 6): EX10 for millions of sales with SIMD bucket indices,
+//   sub-histograms and threads; ./a.out --bench compares it with the EX10 loop.
+// - Distinct filter (Helper 7): EX15's seen[] for any 32/64-bit ids: dense bitset,
+//   open-addressing hash set or blocked Bloom filter, batched with prefetch.
+// - Distinct count (Helper 8): HyperLogLog sketch when only "how many unique?"
+//   matters; mergeable + serialisable (./a.out --hll FILE [precision] [--sketch OUT]).
 
 #include <iostream>
 #include <iomanip>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#include <cstdint>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <unordered_set>
+#include <cmath>
+#include <string>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using std::cin;
 using std::cout;
@@ -122,7 +154,994 @@ void bubbleSortEarlyExit(int arr[], int arrSize) {
     }
 }
 
-int main() {
+/* ============================================================================
+   FastInput: zero-copy line reader + number parser for large input files
+   Why:
+   - cin >> value goes through the iostream/locale machinery for every value
+     and is far too slow for multi-GB input files.
+   How:
+   - Regular file: mmap the whole file (no copy; the kernel pages it in).
+   - stdin / pipes (or if mmap fails): fread 1 MB blocks; a line cut at the
+     end of a block is moved to the front before the next fread.
+   - Lines are split by searching '\n' 16/32 bytes at a time (SSE2/AVX2).
+   - Numbers are parsed with std::from_chars: no locale, no allocation.
+     from_chars also accepts "inf" and "nan"; cin does not, so those are
+     bad tokens here too.
+   Token rules (same input as the EX10/EX15 prompts):
+   - numbers separated by spaces/tabs/newlines ("\r\n" files are fine)
+   - readDouble/readInt return false at end of input OR on a bad token
+     (or a read error); failed() tells the two apart (like cin.fail() vs
+     cin.eof()).
+   ========================================================================== */
+class FastInput {
+public:
+    explicit FastInput(const char* path)
+        : file_(nullptr), mapped_(nullptr), mappedSize_(0),
+          cur_(nullptr), end_(nullptr), tokCur_(nullptr), tokEnd_(nullptr),
+          eof_(false), failed_(false) {
+        if (std::strcmp(path, "-") == 0) {
+            file_ = stdin;
+        } else {
+#if defined(__unix__) || defined(__APPLE__)
+            int fd = open(path, O_RDONLY);
+            struct stat st;
+            if (fd >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+                void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+                    mapped_ = static_cast<const char*>(p);
+                    mappedSize_ = static_cast<size_t>(st.st_size);
+                    cur_ = mapped_;
+                    end_ = mapped_ + mappedSize_;
+                    eof_ = true;    // nothing more to read: the whole file is visible
+                }
+            }
+            if (fd >= 0) close(fd);
+            if (mapped_ != nullptr) return;
+#endif
+            file_ = std::fopen(path, "rb");
+            if (file_ == nullptr) {
+                failed_ = true;
+                eof_ = true;
+            }
+        }
+        buffer_.resize(kBlockSize);
+        cur_ = end_ = buffer_.data();
+    }
+
+    ~FastInput() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (mapped_ != nullptr) munmap(const_cast<char*>(mapped_), mappedSize_);
+#endif
+        if (file_ != nullptr && file_ != stdin) std::fclose(file_);
+    }
+
+    FastInput(const FastInput&) = delete;
+    FastInput& operator=(const FastInput&) = delete;
+
+    bool failed() const { return failed_; }
+
+    // Next line as [begin, end) without the '\n' (and without a trailing '\r')
+    bool nextLine(const char*& begin, const char*& end) {
+        for (;;) {
+            const char* nl = findNewline(cur_, end_);
+            if (nl != nullptr || (eof_ && cur_ < end_)) {
+                begin = cur_;
+                end = (nl != nullptr) ? nl : end_;
+                cur_ = (nl != nullptr) ? nl + 1 : end_;
+                if (end > begin && end[-1] == '\r') --end;
+                return true;
+            }
+            if (eof_) return false;
+            refill();
+        }
+    }
+
+    bool readDouble(double& value) { return readNumber(value); }
+    bool readInt(long long& value) { return readNumber(value); }
+
+private:
+    static constexpr size_t kBlockSize = size_t(1) << 20;
+
+    std::FILE* file_;
+    const char* mapped_;
+    size_t mappedSize_;
+    std::vector<char> buffer_;
+    const char* cur_;      // unread bytes are [cur_, end_)
+    const char* end_;
+    const char* tokCur_;   // unread part of the current line
+    const char* tokEnd_;
+    bool eof_;
+    bool failed_;
+
+    static const char* findNewline(const char* p, const char* end) {
+#if defined(__AVX2__)
+        const __m256i nl = _mm256_set1_epi8('\n');
+        for (; end - p >= 32; p += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nl)));
+            if (mask != 0) return p + __builtin_ctz(mask);
+        }
+#elif defined(__SSE2__)
+        const __m128i nl = _mm_set1_epi8('\n');
+        for (; end - p >= 16; p += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)));
+            if (mask != 0) return p + __builtin_ctz(mask);
+        }
+#endif
+        for (; p < end; p++) {
+            if (*p == '\n') return p;
+        }
+        return nullptr;
+    }
+
+    // Keep the unfinished line, then append the next block from the file
+    void refill() {
+        size_t keep = static_cast<size_t>(end_ - cur_);
+        if (keep + kBlockSize > buffer_.size()) {
+            // a line longer than the buffer: grow (lines are never split)
+            std::vector<char> bigger(keep + kBlockSize);
+            std::memcpy(bigger.data(), cur_, keep);
+            buffer_.swap(bigger);
+        } else {
+            std::memmove(buffer_.data(), cur_, keep);
+        }
+        size_t got = std::fread(buffer_.data() + keep, 1, buffer_.size() - keep, file_);
+        cur_ = buffer_.data();
+        end_ = cur_ + keep + got;
+        if (got == 0) {
+            eof_ = true;
+            if (std::ferror(file_)) failed_ = true;   // e.g. a directory: a read error, not an empty file
+        }
+    }
+
+    template <typename T>
+    bool readNumber(T& value) {
+        for (;;) {
+            while (tokCur_ < tokEnd_ && (*tokCur_ == ' ' || *tokCur_ == '\t')) tokCur_++;
+            if (tokCur_ < tokEnd_) break;
+            if (!nextLine(tokCur_, tokEnd_)) return false;   // end of input
+        }
+        std::from_chars_result r = std::from_chars(tokCur_, tokEnd_, value);
+        if (r.ec != std::errc() || (r.ptr < tokEnd_ && *r.ptr != ' ' && *r.ptr != '\t')) {
+            failed_ = true;    // not a number (same as cin failing)
+            return false;
+        }
+        if constexpr (std::is_floating_point<T>::value) {
+            if (!std::isfinite(value)) {
+                failed_ = true;
+                return false;
+            }
+        }
+        tokCur_ = r.ptr;
+        return true;
+    }
+};
+
+/* ============================================================================
+   Helper 6: Bulk salary bucketing (EX10 for hundreds of millions of sales)
+   Same answer as calculateSalary + checkEarningsAgainstCounter for valid
+   sales (>= 0), but:
+   1) Bucket edges are data, not code:
+      - uniform: SalaryBuckets(base, width, count) -> EX10 is (200, 100, 9)
+      - any ascending lower edges: SalaryBuckets({200, 500, 1000, 5000})
+      Bucket i = [edge i, edge i+1), last bucket open-ended, below the first
+      edge = not counted. That is the rule Helper 3 states; Helper 3 itself
+      still counts salaries 101..199 in bucket 0 because (earnings - 200) / 100
+      truncates toward zero. Only negative sales can produce those.
+   2) No branches for the index. Internally slot 0 means "below range" and
+      slot i+1 is bucket i, so clamping replaces the if-statements:
+      - uniform: y = clamp(salary - base + width, 0, (count+1)*width - 1)
+                 slot = y / width, done as (y * magic) >> shift (checked
+                 exact for every possible y when the buckets are built)
+      - general: slot = number of edges <= salary (one compare per edge)
+      AVX2 does 8 sales per step: int->double, salary = (int)(200 + 0.09*s)
+      exactly like calculateSalary, then min/max clamp + multiply + shift.
+   3) Counting: incrementing counts[slot] for consecutive equal slots makes
+      each increment wait for the previous store (store-to-load forwarding).
+      Real sales pile into one or two buckets, so we keep 4 sub-histograms
+      and rotate between them, adding them up at the end.
+   4) Threads: each thread fills its own histogram; histograms are added.
+   ========================================================================== */
+struct SalaryBuckets {
+    std::vector<int> edges;   // lower edge of each bucket, ascending
+    bool uniform = false;
+    int base = 0;
+    int width = 1;
+    int limit = 0;            // (count + 1) * width: y is clamped below this
+    uint32_t magic = 0;       // y / width == (y * magic) >> shift for y < limit
+    int shift = 0;
+
+    SalaryBuckets(int bucketBase, int bucketWidth, int bucketCount) {
+        for (int i = 0; i < bucketCount; i++) edges.push_back(bucketBase + i * bucketWidth);
+        base = bucketBase;
+        width = bucketWidth;
+        limit = (bucketCount + 1) * bucketWidth;
+        // find the smallest shift whose rounded-up reciprocal divides exactly
+        for (int s = 0; s < 32 && !uniform; s++) {
+            uint64_t m = ((uint64_t(1) << s) + static_cast<uint64_t>(width) - 1) / static_cast<uint64_t>(width);
+            if (m * static_cast<uint64_t>(limit) >= (uint64_t(1) << 31)) break;
+            bool exact = true;
+            for (int y = 0; y < limit && exact; y++) {
+                exact = ((static_cast<uint64_t>(y) * m) >> s) == static_cast<uint64_t>(y / width);
+            }
+            if (exact) {
+                uniform = true;
+                magic = static_cast<uint32_t>(m);
+                shift = s;
+            }
+        }
+    }
+
+    explicit SalaryBuckets(const std::vector<int>& lowerEdges) : edges(lowerEdges) {}
+
+    int bucketCount() const { return static_cast<int>(edges.size()); }
+
+    // 0 = below the first edge, i + 1 = bucket i
+    int slotOf(int salary) const {
+        if (uniform) {
+            long long y = static_cast<long long>(salary) - base + width;
+            y = std::min<long long>(std::max<long long>(y, 0), limit - 1);
+            return static_cast<int>((static_cast<uint32_t>(y) * magic) >> shift);
+        }
+        int slot = 0;
+        for (int edge : edges) slot += (salary >= edge) ? 1 : 0;
+        return slot;
+    }
+};
+
+// Adds the salaries of sales[begin, end) into counts[0..bucketCount-1]
+void bucketSalesRange(const int sales[], size_t begin, size_t end,
+                      const SalaryBuckets& buckets, uint64_t counts[]) {
+    const int slots = buckets.bucketCount() + 1;
+    std::vector<uint32_t> sub(4 * static_cast<size_t>(slots), 0);
+    uint32_t* sub0 = sub.data();
+    uint32_t* sub1 = sub0 + slots;
+    uint32_t* sub2 = sub1 + slots;
+    uint32_t* sub3 = sub2 + slots;
+
+    // uint32 sub-counts: flush before any of them could wrap
+    const size_t kFlushEvery = size_t(1) << 30;
+    auto flush = [&]() {
+        for (int i = 1; i < slots; i++) {
+            counts[i - 1] += uint64_t(sub0[i]) + sub1[i] + sub2[i] + sub3[i];
+        }
+        std::fill(sub.begin(), sub.end(), 0U);
+    };
+
+    size_t i = begin;
+    while (i < end) {
+        size_t stop = std::min(end, i + kFlushEvery);
+#if defined(__AVX2__)
+        const __m256d k200 = _mm256_set1_pd(200.0);
+        const __m256d k009 = _mm256_set1_pd(0.09);
+        const __m256i offset = _mm256_set1_epi32(buckets.width - buckets.base);
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i top = _mm256_set1_epi32(buckets.limit - 1);
+        const __m256i magic = _mm256_set1_epi32(static_cast<int>(buckets.magic));
+        const __m128i shift = _mm_cvtsi32_si128(buckets.shift);
+        alignas(32) int slot[8];
+        for (; i + 8 <= stop; i += 8) {
+            __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sales + i));
+            __m256d lo = _mm256_add_pd(k200, _mm256_mul_pd(k009, _mm256_cvtepi32_pd(_mm256_castsi256_si128(s))));
+            __m256d hi = _mm256_add_pd(k200, _mm256_mul_pd(k009, _mm256_cvtepi32_pd(_mm256_extracti128_si256(s, 1))));
+            __m256i salary = _mm256_set_m128i(_mm256_cvttpd_epi32(hi), _mm256_cvttpd_epi32(lo));
+            __m256i idx;
+            if (buckets.uniform) {
+                __m256i y = _mm256_min_epi32(_mm256_max_epi32(_mm256_add_epi32(salary, offset), zero), top);
+                idx = _mm256_srl_epi32(_mm256_mullo_epi32(y, magic), shift);
+            } else {
+                // slot = edges <= salary = edgeCount - (edges > salary); masks are -1
+                idx = _mm256_set1_epi32(buckets.bucketCount());
+                for (int edge : buckets.edges) {
+                    idx = _mm256_add_epi32(idx, _mm256_cmpgt_epi32(_mm256_set1_epi32(edge), salary));
+                }
+            }
+            _mm256_store_si256(reinterpret_cast<__m256i*>(slot), idx);
+            sub0[slot[0]]++;
+            sub1[slot[1]]++;
+            sub2[slot[2]]++;
+            sub3[slot[3]]++;
+            sub0[slot[4]]++;
+            sub1[slot[5]]++;
+            sub2[slot[6]]++;
+            sub3[slot[7]]++;
+        }
+#endif
+        for (; i + 4 <= stop; i += 4) {
+            sub0[buckets.slotOf(calculateSalary(sales[i]))]++;
+            sub1[buckets.slotOf(calculateSalary(sales[i + 1]))]++;
+            sub2[buckets.slotOf(calculateSalary(sales[i + 2]))]++;
+            sub3[buckets.slotOf(calculateSalary(sales[i + 3]))]++;
+        }
+        for (; i < stop; i++) {
+            sub0[buckets.slotOf(calculateSalary(sales[i]))]++;
+        }
+        flush();
+    }
+}
+
+// counts must hold bucketCount() entries; it is overwritten. threadCount 0 = one per core
+void bucketSales(const int sales[], size_t count, const SalaryBuckets& buckets,
+                 uint64_t counts[], unsigned threadCount = 0) {
+    const size_t n = static_cast<size_t>(buckets.bucketCount());
+    std::fill(counts, counts + n, 0ULL);
+    if (threadCount == 0) {
+        threadCount = std::max(1U, std::thread::hardware_concurrency());
+    }
+    const size_t kMinChunk = size_t(1) << 16;
+    threadCount = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threadCount, count / kMinChunk)));
+    if (threadCount == 1) {
+        bucketSalesRange(sales, 0, count, buckets, counts);
+        return;
+    }
+
+    std::vector<uint64_t> local(threadCount * n, 0ULL);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threadCount; t++) {
+        workers.emplace_back([&, t]() {
+            bucketSalesRange(sales, count * t / threadCount, count * (t + 1) / threadCount,
+                             buckets, local.data() + t * n);
+        });
+    }
+    for (std::thread& w : workers) w.join();
+    for (unsigned t = 0; t < threadCount; t++) {
+        for (size_t b = 0; b < n; b++) counts[b] += local[t * n + b];
+    }
+}
+
+/* ============================================================================
+   Benchmark: ./a.out --bench
+   - EX10 loop (calculateSalary + checkEarningsAgainstCounter) vs bucketSales
+   - skewed sales (most people in two buckets) to show the sub-histogram win
+   - also checks a non-uniform edge list against slotOf one value at a time
+   ========================================================================== */
+int benchmarkBucketing() {
+    const size_t kSales = size_t(1) << 26;
+    std::vector<int> sales(kSales);
+    std::mt19937 rng(10);
+    std::uniform_int_distribution<int> common(1000, 4000);   // salary 290..560
+    std::uniform_int_distribution<int> any(0, 20000);
+    for (size_t i = 0; i < kSales; i++) {
+        sales[i] = (rng() % 8 != 0) ? common(rng) : any(rng);
+    }
+
+    auto timeIt = [kSales](auto&& body) {
+        double best = 1e300;
+        for (int round = 0; round < 3; round++) {
+            auto t0 = std::chrono::steady_clock::now();
+            body();
+            auto t1 = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count());
+        }
+        return best / static_cast<double>(kSales);
+    };
+
+    const int ranges = 9;
+    int counter[ranges] = {0};
+    double loopNs = timeIt([&]() {
+        std::fill(counter, counter + ranges, 0);
+        for (size_t i = 0; i < kSales; i++) checkEarningsAgainstCounter(counter, calculateSalary(sales[i]));
+    });
+
+    SalaryBuckets ex10(200, 100, ranges);
+    uint64_t counts[ranges];
+    double oneThreadNs = timeIt([&]() { bucketSales(sales.data(), kSales, ex10, counts, 1); });
+    double allThreadsNs = timeIt([&]() { bucketSales(sales.data(), kSales, ex10, counts); });
+    bool same = true;
+    for (int b = 0; b < ranges; b++) same = same && (counts[b] == static_cast<uint64_t>(counter[b]));
+
+    SalaryBuckets custom(std::vector<int>{250, 400, 450, 1000, 2000});
+    uint64_t customCounts[5];
+    uint64_t expected[5] = {0, 0, 0, 0, 0};
+    double customNs = timeIt([&]() { bucketSales(sales.data(), kSales, custom, customCounts, 1); });
+    for (size_t i = 0; i < kSales; i++) {
+        int slot = custom.slotOf(calculateSalary(sales[i]));
+        if (slot > 0) expected[slot - 1]++;
+    }
+    for (int b = 0; b < 5; b++) same = same && (customCounts[b] == expected[b]);
+
+    cout << "Salary bucketing, " << kSales << " sales (ns/sale, best of 3):\n";
+    cout << "  EX10 loop                  : " << loopNs << "\n";
+    cout << "  bucketSales 1 thread       : " << oneThreadNs << "\n";
+    cout << "  bucketSales all cores      : " << allThreadsNs
+         << " (" << std::max(1U, std::thread::hardware_concurrency()) << " threads)\n";
+    cout << "  custom edges, 1 thread     : " << customNs << "\n";
+    cout << "  same counts                : " << (same ? "yes" : "NO") << "\n";
+    return same ? 0 : 1;
+}
+
+/* ============================================================================
+   Helper 7: Distinct filter (EX15's seen[] for arbitrary 32/64-bit ids)
+   EX15 works because the value range is tiny (91 values). For real ids we
+   pick the structure from what we know about the range:
+   1) Dense bitset - range known and at most kMaxDenseBits values:
+      1 bit per POSSIBLE value (EX15 used 1 byte); index = value - minKey.
+   2) Hash set - range unknown / huge: open addressing, linear probing,
+      keys stored inline (no node per key like std::unordered_set),
+      max load 1/2. The key all-ones marks an empty slot and is tracked
+      with a separate flag.
+   3) Blocked Bloom filter - approximate: each key picks one 32-byte block
+      (one cache line access) and sets 8 bits in it. Never lets a duplicate
+      through, but drops a small fraction of first occurrences (~0.5% at
+      16 bits per key). Use it when memory matters more than exactness.
+   Batching (filter): hash a block of 16 ids, prefetch their slots/blocks,
+   then do the inserts - the cache misses of the 16 ids overlap instead of
+   being paid one after another.
+   ========================================================================== */
+enum class DedupMode { DenseBitset, HashSet, BloomApprox };
+
+// 64-bit finaliser (murmur3 fmix64): sequential ids become random-looking bits
+inline uint64_t mixId(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    return x ^ (x >> 33);
+}
+
+template <typename Key>
+class DistinctFilter {
+public:
+    static constexpr uint64_t kMaxDenseBits = uint64_t(1) << 30;   // 128 MB
+
+    // known range [minKey, maxKey]: dense bitset when small enough, else hash set
+    static DistinctFilter forRange(Key minKey, Key maxKey) {
+        uint64_t span = static_cast<uint64_t>(maxKey - minKey);
+        if (span < kMaxDenseBits) {
+            DistinctFilter f(DedupMode::DenseBitset);
+            f.minKey_ = minKey;
+            f.bits_.assign(static_cast<size_t>(span / 64 + 1), 0ULL);
+            return f;
+        }
+        return hashed(1024);
+    }
+
+    static DistinctFilter hashed(size_t expectedDistinct) {
+        DistinctFilter f(DedupMode::HashSet);
+        size_t capacity = 16;
+        while (capacity < 2 * expectedDistinct) capacity *= 2;
+        f.slots_.assign(capacity, kEmpty);
+        return f;
+    }
+
+    static DistinctFilter bloom(size_t expectedDistinct, unsigned bitsPerKey = 16) {
+        DistinctFilter f(DedupMode::BloomApprox);
+        size_t blocks = 1;
+        while (blocks * 256 < static_cast<size_t>(bitsPerKey) * expectedDistinct) blocks *= 2;
+        f.blocks_.assign(blocks * 8, 0U);
+        return f;
+    }
+
+    DedupMode mode() const { return mode_; }
+    size_t distinctCount() const { return distinct_; }
+
+    size_t memoryBytes() const {
+        return bits_.capacity() * sizeof(uint64_t) + slots_.capacity() * sizeof(Key) +
+               blocks_.capacity() * sizeof(uint32_t);
+    }
+
+    // true on the first occurrence of key
+    bool insert(Key key) {
+        switch (mode_) {
+        case DedupMode::DenseBitset:
+            return insertDense(key);
+        case DedupMode::HashSet:
+            if (2 * (distinct_ + 1) > slots_.size()) grow();
+            return insertHashed(key, homeSlot(key));
+        default:
+            return insertBloom(mix(key));
+        }
+    }
+
+    // Copies the first occurrences of in[0..count) to firstSeen (input order kept)
+    // and returns how many; firstSeen may alias in.
+    size_t filter(const Key in[], size_t count, Key firstSeen[]) {
+        const size_t kBatch = 16;
+        size_t written = 0;
+        uint64_t where[kBatch];
+        for (size_t start = 0; start < count; start += kBatch) {
+            size_t n = std::min(kBatch, count - start);
+            if (mode_ == DedupMode::HashSet) {
+                // grow up front so the prefetched slots stay valid for the batch
+                while (2 * (distinct_ + n) > slots_.size()) grow();
+            }
+            for (size_t j = 0; j < n; j++) {
+                Key key = in[start + j];
+                if (mode_ == DedupMode::DenseBitset) {
+                    where[j] = static_cast<uint64_t>(key - minKey_) / 64;
+                    if (key >= minKey_ && where[j] < bits_.size()) __builtin_prefetch(&bits_[where[j]], 1);
+                } else if (mode_ == DedupMode::HashSet) {
+                    where[j] = homeSlot(key);
+                    __builtin_prefetch(&slots_[where[j]], 1);
+                } else {
+                    where[j] = mix(key);
+                    __builtin_prefetch(&blocks_[blockOf(where[j])], 1);
+                }
+            }
+            for (size_t j = 0; j < n; j++) {
+                Key key = in[start + j];
+                bool first = (mode_ == DedupMode::DenseBitset) ? insertDense(key)
+                             : (mode_ == DedupMode::HashSet)   ? insertHashed(key, where[j])
+                                                                : insertBloom(where[j]);
+                firstSeen[written] = key;
+                written += first ? 1 : 0;
+            }
+        }
+        return written;
+    }
+
+private:
+    static constexpr Key kEmpty = static_cast<Key>(~Key(0));
+
+    DedupMode mode_;
+    size_t distinct_ = 0;
+    Key minKey_ = 0;
+    std::vector<uint64_t> bits_;     // DenseBitset
+    std::vector<Key> slots_;         // HashSet
+    bool hasEmptyKey_ = false;       // HashSet: the key equal to kEmpty
+    std::vector<uint32_t> blocks_;   // BloomApprox: 8 words per block
+
+    explicit DistinctFilter(DedupMode mode) : mode_(mode) {}
+
+    static uint64_t mix(Key key) { return mixId(static_cast<uint64_t>(key)); }
+
+    uint64_t homeSlot(Key key) const { return mix(key) & (slots_.size() - 1); }
+
+    bool insertDense(Key key) {
+        uint64_t offset = static_cast<uint64_t>(key - minKey_);
+        if (key < minKey_ || offset / 64 >= bits_.size()) return false;   // outside the declared range
+        uint64_t& word = bits_[static_cast<size_t>(offset / 64)];
+        uint64_t bit = uint64_t(1) << (offset % 64);
+        bool first = (word & bit) == 0;
+        word |= bit;
+        distinct_ += first ? 1 : 0;
+        return first;
+    }
+
+    bool insertHashed(Key key, uint64_t slot) {
+        if (key == kEmpty) {
+            bool first = !hasEmptyKey_;
+            hasEmptyKey_ = true;
+            distinct_ += first ? 1 : 0;
+            return first;
+        }
+        size_t mask = slots_.size() - 1;
+        for (size_t i = static_cast<size_t>(slot);; i = (i + 1) & mask) {
+            if (slots_[i] == key) return false;
+            if (slots_[i] == kEmpty) {
+                slots_[i] = key;
+                distinct_++;
+                return true;
+            }
+        }
+    }
+
+    void grow() {
+        std::vector<Key> old(slots_.size() * 2, kEmpty);
+        old.swap(slots_);
+        size_t mask = slots_.size() - 1;
+        for (Key key : old) {
+            if (key == kEmpty) continue;
+            size_t i = static_cast<size_t>(homeSlot(key));
+            while (slots_[i] != kEmpty) i = (i + 1) & mask;
+            slots_[i] = key;
+        }
+    }
+
+    // Split-block Bloom filter: block from the high hash bits, and one bit in
+    // each of the block's 8 words from (low32 * salt[i]) >> 27
+    size_t blockOf(uint64_t hash) const {
+        return static_cast<size_t>((hash >> 32) & (blocks_.size() / 8 - 1)) * 8;
+    }
+
+    bool insertBloom(uint64_t hash) {
+        static const uint32_t kSalt[8] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                          0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+        uint32_t* block = &blocks_[blockOf(hash)];
+        uint32_t low = static_cast<uint32_t>(hash);
+#if defined(__AVX2__)
+        __m256i bits = _mm256_sllv_epi32(_mm256_set1_epi32(1),
+                                         _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(low)),
+                                                                              _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kSalt))), 27));
+        __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+        bool seen = _mm256_testc_si256(current, bits) != 0;   // all 8 bits already set
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(block), _mm256_or_si256(current, bits));
+#else
+        bool seen = true;
+        for (int i = 0; i < 8; i++) {
+            uint32_t bit = 1U << ((low * kSalt[i]) >> 27);
+            seen = seen && (block[i] & bit) != 0;
+            block[i] |= bit;
+        }
+#endif
+        distinct_ += seen ? 0 : 1;
+        return !seen;
+    }
+};
+
+/* ============================================================================
+   Benchmark (part of ./a.out --bench): 2^24 ids, 2^22 distinct, random order
+   - std::unordered_set as the "obvious" exact baseline
+   - hash set one insert at a time vs batched filter (prefetch)
+   - Bloom filter (approximate) and dense bitset (ids known to be < 2^26)
+   ========================================================================== */
+int benchmarkDistinct() {
+    const size_t kIds = size_t(1) << 24;
+    const size_t kDistinct = size_t(1) << 22;
+    std::mt19937_64 rng(15);
+    std::vector<uint64_t> pool(kDistinct);
+    for (uint64_t& id : pool) id = rng() & ((uint64_t(1) << 26) - 1);
+    std::vector<uint64_t> ids(kIds);
+    for (uint64_t& id : ids) id = pool[rng() % kDistinct];
+    std::vector<uint64_t> out(kIds);
+
+    std::unordered_set<uint64_t> reference;
+    for (uint64_t id : ids) reference.insert(id);
+    const double distinct = static_cast<double>(reference.size());
+
+    cout << "Distinct filter, " << kIds << " ids, " << reference.size() << " distinct:\n";
+    auto report = [&](const char* name, double secs, size_t found, size_t bytes) {
+        cout << "  " << setw(22) << std::left << name << std::right << ": " << setw(6)
+             << (secs * 1e9 / static_cast<double>(kIds)) << " ns/id, " << setw(6)
+             << (static_cast<double>(bytes) / distinct) << " bytes/distinct, found " << found << "\n";
+    };
+    auto seconds = [](auto t0, auto t1) { return std::chrono::duration<double>(t1 - t0).count(); };
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::unordered_set<uint64_t> baseline;
+    size_t found = 0;
+    for (uint64_t id : ids) found += baseline.insert(id).second ? 1 : 0;
+    auto t1 = std::chrono::steady_clock::now();
+    // nodes + bucket array, roughly (libstdc++: 16-byte node + malloc header, 8-byte bucket)
+    report("std::unordered_set", seconds(t0, t1), found, baseline.size() * 32 + baseline.bucket_count() * 8);
+
+    t0 = std::chrono::steady_clock::now();
+    DistinctFilter<uint64_t> single = DistinctFilter<uint64_t>::hashed(1024);
+    found = 0;
+    for (uint64_t id : ids) found += single.insert(id) ? 1 : 0;
+    t1 = std::chrono::steady_clock::now();
+    report("hash set, one by one", seconds(t0, t1), found, single.memoryBytes());
+    bool ok = (found == reference.size());
+
+    t0 = std::chrono::steady_clock::now();
+    DistinctFilter<uint64_t> batched = DistinctFilter<uint64_t>::hashed(1024);
+    found = batched.filter(ids.data(), kIds, out.data());
+    t1 = std::chrono::steady_clock::now();
+    report("hash set, batched", seconds(t0, t1), found, batched.memoryBytes());
+    ok = ok && (found == reference.size());
+
+    t0 = std::chrono::steady_clock::now();
+    DistinctFilter<uint64_t> bloom = DistinctFilter<uint64_t>::bloom(kDistinct);
+    found = bloom.filter(ids.data(), kIds, out.data());
+    t1 = std::chrono::steady_clock::now();
+    report("Bloom (approximate)", seconds(t0, t1), found, bloom.memoryBytes());
+    ok = ok && (found <= reference.size());
+
+    t0 = std::chrono::steady_clock::now();
+    DistinctFilter<uint64_t> dense = DistinctFilter<uint64_t>::forRange(0, (uint64_t(1) << 26) - 1);
+    found = dense.filter(ids.data(), kIds, out.data());
+    t1 = std::chrono::steady_clock::now();
+    report("dense bitset", seconds(t0, t1), found, dense.memoryBytes());
+    ok = ok && (found == reference.size());
+
+    cout << "  " << setw(22) << std::left << "exact modes agree" << std::right << ": " << (ok ? "yes" : "NO") << "\n";
+    return ok ? 0 : 1;
+}
+
+/* ============================================================================
+   Helper 8: HyperLogLog distinct count (when EX15 only needs "how many")
+   Idea:
+   - Hash each value to 64 random-looking bits. The top p bits pick one of
+     m = 2^p registers; the register keeps the longest run of leading zeros
+     (+1) seen in the remaining bits. Seeing a run of k zeros suggests ~2^k
+     distinct values, and averaging over m registers (harmonic mean) makes
+     that a good estimate: standard error ~ 1.04 / sqrt(m).
+       p = 10 ->  1 KB, ~3.3%     p = 14 -> 16 KB, ~0.8%     p = 18 -> 256 KB, ~0.2%
+   - Memory is m bytes whatever the stream size (exact needs ~1 bit..16 bytes
+     PER distinct value, see Helper 7).
+   - merge = per-register max, so sketches from threads, shards or files
+     combine exactly as if one sketch had seen all the values. AVX2 does the
+     max 32 registers at a time.
+   - serialize(): "HLL1" + precision byte + m register bytes; deserialize()
+     checks the header and size.
+   - Small counts use linear counting (m * ln(m / emptyRegisters)), which is
+     the usual correction; with a 64-bit hash no large-range correction.
+   ========================================================================== */
+class HyperLogLog {
+public:
+    explicit HyperLogLog(unsigned precision = 14)
+        : precision_(std::min(18U, std::max(4U, precision))),
+          registers_(size_t(1) << precision_, 0) {}
+
+    unsigned precision() const { return precision_; }
+
+    void add(uint64_t value) {
+        uint64_t hash = mixId(value);
+        size_t index = static_cast<size_t>(hash >> (64 - precision_));
+        // sentinel bit stops the count at 64 - p zeros
+        uint64_t rest = (hash << precision_) | (uint64_t(1) << (precision_ - 1));
+        uint8_t rank = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+        registers_[index] = std::max(registers_[index], rank);
+    }
+
+    void addBatch(const uint64_t values[], size_t count) {
+        for (size_t i = 0; i < count; i++) add(values[i]);
+    }
+
+    // false (and nothing changes) if the precisions differ
+    bool merge(const HyperLogLog& other) {
+        if (other.precision_ != precision_) return false;
+        uint8_t* dst = registers_.data();
+        const uint8_t* src = other.registers_.data();
+        size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 32 <= registers_.size(); i += 32) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_max_epu8(a, b));
+        }
+#elif defined(__SSE2__)
+        for (; i + 16 <= registers_.size(); i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_max_epu8(a, b));
+        }
+#endif
+        for (; i < registers_.size(); i++) dst[i] = std::max(dst[i], src[i]);
+        return true;
+    }
+
+    double estimate() const {
+        const double m = static_cast<double>(registers_.size());
+        double sum = 0.0;
+        size_t empty = 0;
+        for (uint8_t r : registers_) {
+            sum += std::ldexp(1.0, -static_cast<int>(r));
+            empty += (r == 0) ? 1 : 0;
+        }
+        double alpha = (registers_.size() == 16)   ? 0.673
+                       : (registers_.size() == 32) ? 0.697
+                       : (registers_.size() == 64) ? 0.709
+                                                   : 0.7213 / (1.0 + 1.079 / m);
+        double raw = alpha * m * m / sum;
+        if (raw <= 2.5 * m && empty != 0) {
+            return m * std::log(m / static_cast<double>(empty));
+        }
+        return raw;
+    }
+
+    std::vector<uint8_t> serialize() const {
+        std::vector<uint8_t> bytes = {'H', 'L', 'L', '1', static_cast<uint8_t>(precision_)};
+        bytes.insert(bytes.end(), registers_.begin(), registers_.end());
+        return bytes;
+    }
+
+    // false if bytes is not a sketch written by serialize()
+    static bool deserialize(const uint8_t bytes[], size_t size, HyperLogLog& out) {
+        if (size < 5 || std::memcmp(bytes, "HLL1", 4) != 0 || bytes[4] < 4 || bytes[4] > 18) return false;
+        HyperLogLog sketch(bytes[4]);
+        if (size != 5 + sketch.registers_.size()) return false;
+        std::memcpy(sketch.registers_.data(), bytes + 5, sketch.registers_.size());
+        out = sketch;
+        return true;
+    }
+
+private:
+    unsigned precision_;
+    std::vector<uint8_t> registers_;
+};
+
+// One sketch per thread over its chunk, merged at the end
+HyperLogLog countDistinctParallel(const uint64_t values[], size_t count, unsigned precision,
+                                  unsigned threadCount = 0) {
+    if (threadCount == 0) {
+        threadCount = std::max(1U, std::thread::hardware_concurrency());
+    }
+    const size_t kMinChunk = size_t(1) << 16;
+    threadCount = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threadCount, count / kMinChunk)));
+    std::vector<HyperLogLog> partial(threadCount, HyperLogLog(precision));
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threadCount; t++) {
+        workers.emplace_back([&, t]() {
+            size_t begin = count * t / threadCount;
+            partial[t].addBatch(values + begin, count * (t + 1) / threadCount - begin);
+        });
+    }
+    partial[0].addBatch(values, count / threadCount);
+    for (std::thread& w : workers) w.join();
+    for (unsigned t = 1; t < threadCount; t++) partial[0].merge(partial[t]);
+    return partial[0];
+}
+
+/* ============================================================================
+   Distinct-count mode: ./a.out --hll FILE [precision] [--sketch OUT]
+   - every integer in the file (until -1 or end of file)
+   - --sketch OUT also writes the serialised sketch to OUT, so runs over
+     several files can be merged later without re-reading the data
+     (nothing is written without it: FILE may be - or a read-only place)
+   ========================================================================== */
+int runDistinctCount(const char* path, unsigned precision, const char* sketchPath) {
+    FastInput in(path);
+    if (in.failed()) {
+        cout << "Cannot open " << path << "\n";
+        return 1;
+    }
+    std::vector<uint64_t> values;
+    long long value = 0;
+    while (in.readInt(value) && value != -1) values.push_back(static_cast<uint64_t>(value));
+    if (in.failed()) {
+        cout << "Invalid input. Exiting.\n";
+        return 1;
+    }
+    HyperLogLog sketch = countDistinctParallel(values.data(), values.size(), precision);
+    cout << "EX15 Values: " << values.size() << ", distinct (HLL p=" << sketch.precision()
+         << "): ~" << static_cast<uint64_t>(std::llround(sketch.estimate())) << "\n";
+
+    if (sketchPath == nullptr) return 0;
+    std::vector<uint8_t> bytes = sketch.serialize();
+    std::FILE* out = std::fopen(sketchPath, "wb");
+    bool written = out != nullptr && std::fwrite(bytes.data(), 1, bytes.size(), out) == bytes.size();
+    if (out != nullptr && std::fclose(out) != 0) written = false;
+    if (!written) {
+        cout << "Cannot write " << sketchPath << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+/* ============================================================================
+   Benchmark (part of ./a.out --bench): 2^24 ids, ~4M distinct
+   - exact count with DistinctFilter (hash set) vs HyperLogLog p = 14
+   - sketch split over 8 partial sketches + serialize/deserialize + merge
+     must give exactly the single-sketch registers
+   ========================================================================== */
+int benchmarkHyperLogLog() {
+    const size_t kIds = size_t(1) << 24;
+    std::mt19937_64 rng(42);
+    std::vector<uint64_t> ids(kIds);
+    for (uint64_t& id : ids) id = rng() % (uint64_t(1) << 22) * 7919;
+
+    auto seconds = [](auto t0, auto t1) { return std::chrono::duration<double>(t1 - t0).count(); };
+
+    auto t0 = std::chrono::steady_clock::now();
+    DistinctFilter<uint64_t> exact = DistinctFilter<uint64_t>::hashed(1024);
+    for (uint64_t id : ids) exact.insert(id);
+    auto t1 = std::chrono::steady_clock::now();
+    double exactNs = seconds(t0, t1) * 1e9 / kIds;
+
+    t0 = std::chrono::steady_clock::now();
+    HyperLogLog single(14);
+    single.addBatch(ids.data(), kIds);
+    double estimate = single.estimate();
+    t1 = std::chrono::steady_clock::now();
+    double hllNs = seconds(t0, t1) * 1e9 / kIds;
+
+    t0 = std::chrono::steady_clock::now();
+    HyperLogLog parallel = countDistinctParallel(ids.data(), kIds, 14);
+    t1 = std::chrono::steady_clock::now();
+    double parallelNs = seconds(t0, t1) * 1e9 / kIds;
+
+    // 8 "files": sketch, serialise, read back, merge
+    HyperLogLog merged(14);
+    bool ok = true;
+    for (size_t part = 0; part < 8; part++) {
+        HyperLogLog piece(14);
+        piece.addBatch(ids.data() + kIds / 8 * part, kIds / 8);
+        std::vector<uint8_t> bytes = piece.serialize();
+        HyperLogLog loaded;
+        ok = ok && HyperLogLog::deserialize(bytes.data(), bytes.size(), loaded) && merged.merge(loaded);
+    }
+    ok = ok && merged.serialize() == single.serialize() && parallel.serialize() == single.serialize();
+
+    double error = (estimate - static_cast<double>(exact.distinctCount())) / static_cast<double>(exact.distinctCount());
+    cout << "Distinct count, " << kIds << " ids:\n";
+    cout << "  exact (hash set)       : " << exact.distinctCount() << " in " << exactNs << " ns/id, "
+         << exact.memoryBytes() / 1024 << " KB\n";
+    cout << "  HyperLogLog p=14       : " << static_cast<uint64_t>(std::llround(estimate)) << " in " << hllNs
+         << " ns/id, 16 KB (error " << (error * 100.0) << "%)\n";
+    cout << "  HLL all cores          : " << parallelNs << " ns/id ("
+         << std::max(1U, std::thread::hardware_concurrency()) << " threads)\n";
+    cout << "  8 sketches merged      : " << (ok ? "identical registers" : "MISMATCH") << "\n";
+    return ok ? 0 : 1;
+}
+
+/* ============================================================================
+   Helper 9: Batch mode for EX10 + EX15
+   - Input: EX10 weekly sales ... -1, then EX15 numbers (10..100).
+   - EX15 keeps reading until -1 or end of input (not just 20 values), so the
+     same presence array filters a whole file. Out-of-range values are skipped
+     because a file, unlike the exercise, gives no range guarantee.
+   ========================================================================== */
+int runBatch(const char* path) {
+    constexpr long long kSentinel = -1;
+    FastInput in(path);
+    if (in.failed()) {
+        cout << "Cannot open " << path << "\n";
+        return 1;
+    }
+
+    std::vector<int> sales;
+    long long value = 0;
+    bool sawSentinel = false;
+    while (in.readInt(value)) {
+        if (value == kSentinel) {
+            sawSentinel = true;
+            break;
+        }
+        sales.push_back(static_cast<int>(value));
+    }
+    if (in.failed()) {
+        cout << "Invalid input. Exiting.\n";
+        return 1;
+    }
+    if (!sawSentinel) {
+        // EX15 needs its own -1-terminated list after this one
+        cout << "Input ended before the -1 sentinel.\n";
+        return 1;
+    }
+
+    const int ranges = 9;
+    uint64_t counter[ranges];
+    bucketSales(sales.data(), sales.size(), SalaryBuckets(200, 100, ranges), counter);
+
+    cout << "EX10 Salary buckets (200-299 ... 1000+):\n";
+    for (int i = 0; i < ranges; i++) {
+        cout << setw(4) << counter[i];
+    }
+    cout << "\n\n";
+
+    // EX15's seen[91] is the dense-bitset case of DistinctFilter
+    DistinctFilter<uint32_t> seen = DistinctFilter<uint32_t>::forRange(10, 100);
+
+    cout << "EX15 Unique numbers:\n";
+    while (in.readInt(value) && value != kSentinel) {
+        if (value < 10 || value > 100) continue;
+        if (seen.insert(static_cast<uint32_t>(value))) {
+            cout << value << " ";
+        }
+    }
+    cout << "\n";
+    if (in.failed()) {
+        cout << "Invalid input. Exiting.\n";
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+        int bucketStatus = benchmarkBucketing();
+        int distinctStatus = benchmarkDistinct();
+        int hllStatus = benchmarkHyperLogLog();
+        return (bucketStatus | distinctStatus | hllStatus) != 0 ? 1 : 0;
+    }
+    if (argc > 2 && std::strcmp(argv[1], "--hll") == 0) {
+        unsigned precision = 14;
+        const char* sketchPath = nullptr;
+        int arg = 3;
+        if (arg < argc && std::strcmp(argv[arg], "--sketch") != 0) {
+            std::from_chars_result r = std::from_chars(argv[arg], argv[arg] + std::strlen(argv[arg]), precision);
+            if (r.ec != std::errc() || *r.ptr != '\0' || precision < 4 || precision > 18) {
+                cout << "Precision must be 4..18\n";
+                return 1;
+            }
+            arg++;
+        }
+        if (arg < argc) {
+            if (std::strcmp(argv[arg], "--sketch") != 0 || arg + 2 != argc) {
+                cout << "Usage: ./a.out --hll FILE [precision] [--sketch OUT]\n";
+                return 1;
+            }
+            sketchPath = argv[arg + 1];
+        }
+        return runDistinctCount(argv[2], precision, sketchPath);
+    }
+    if (argc > 1) {
+        return runBatch(argv[1]);
+    }
 
     /* =========================================================================
        EX10: Salary ranges counter using a single array (bucket indexing)
@@ -7,6 +7,25 @@
 // - Works with C-style strings stored in a char array (null-terminated).
 
 #include <iostream>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <fstream>
+#include <string>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 using std::cout;
 using std::endl;
@@ -102,7 +121,390 @@ bool checkPalindromeRecursive(const char arr[], int start, int end) {
     return checkPalindromeRecursive(arr, start + 1, end - 1);
 }
 
-int main() {
+/* ============================================================================
+   Helper 3: Palindrome check for LONG byte buffers (vectorised two-pointer)
+   Why:
+     - Helper 1 compares one pair per iteration; Helper 2 adds a call per pair.
+       For multi-megabyte buffers we want to compare 32 pairs at once.
+   Idea (same two-pointer pattern, just wider):
+     - front block = buf[lo .. lo+31]
+     - back block  = buf[hi-32 .. hi-1], byte-reversed with a shuffle so that
+       back[0] is the last byte, back[1] the one before it, ...
+     - one vector compare checks 32 (start, end) pairs; movemask != all-ones
+       means some pair differs -> not a palindrome
+     - move inward by 32 on both sides; the middle (< 64 bytes) is scalar
+   Input:
+     - buf: raw bytes, NOT required to be '\0'-terminated
+     - len: number of bytes to check (no terminator counted, unlike Helper 1)
+     - mode: combination of the flags below
+   Modes:
+     - kPalindromeExact     : byte-for-byte
+     - kPalindromeFoldCase  : 'A'..'Z' compare equal to 'a'..'z' (ASCII only)
+     - kPalindromeAlnumOnly : skip everything that is not [0-9A-Za-z]
+       ("A man, a plan, a canal: Panama" with FoldCase|AlnumOnly -> true)
+   AlnumOnly cannot compare in place (skipping shifts the two sides differently),
+   so the kept bytes are first compacted into a scratch buffer with a vectorised
+   filter (classify 16 bytes, pshufb-compact 8 at a time), then checked as Exact.
+   Instruction sets:
+     - AVX2 : 32 pairs per compare
+     - SSE2 : 16 pairs per compare (the x86-64 baseline, so a default build
+              is vectorised too); without SSSE3's pshufb the reversal is
+              3 shuffles + a 16-bit rotate, and AlnumOnly compaction is scalar
+     - other targets: the scalar two-pointer loop
+   ========================================================================== */
+const unsigned kPalindromeExact = 0u;
+const unsigned kPalindromeFoldCase = 1u;
+const unsigned kPalindromeAlnumOnly = 2u;
+
+static inline unsigned char foldAsciiCase(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c | 0x20) : c;
+}
+
+static inline bool isAsciiAlnum(unsigned char c) {
+    unsigned char lower = static_cast<unsigned char>(c | 0x20);
+    return (c >= '0' && c <= '9') || (lower >= 'a' && lower <= 'z');
+}
+
+#if defined(__SSE2__)
+// x in [lo..hi] (unsigned) -> 0xFF per byte: (x - lo) <= (hi - lo) via min
+static inline __m128i bytesInRange(__m128i x, char lo, char hi) {
+    __m128i off = _mm_sub_epi8(x, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(off, _mm_set1_epi8(static_cast<char>(hi - lo))), off);
+}
+#endif
+
+#if defined(__SSSE3__)
+
+// pshufb index table: entry m moves the bytes whose bit is set in m to the front
+struct CompactTable {
+    uint64_t shuffle[256];
+    CompactTable() {
+        for (int m = 0; m < 256; m++) {
+            uint64_t entry = 0;
+            int out = 0;
+            for (int b = 0; b < 8; b++) {
+                if (m & (1 << b)) {
+                    entry |= static_cast<uint64_t>(b) << (8 * out);
+                    out++;
+                }
+            }
+            shuffle[m] = entry;
+        }
+    }
+};
+static const CompactTable kCompactTable;
+#endif
+
+#if defined(__AVX2__)
+static inline __m256i bytesInRange256(__m256i x, char lo, char hi) {
+    __m256i off = _mm256_sub_epi8(x, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(off, _mm256_set1_epi8(static_cast<char>(hi - lo))), off);
+}
+
+static inline __m256i foldCase256(__m256i x) {
+    __m256i upper = bytesInRange256(x, 'A', 'Z');
+    return _mm256_or_si256(x, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+static inline __m256i reverseBytes256(__m256i x) {
+    const __m256i rev = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                         15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    // reverse inside each 128-bit lane, then swap the two lanes
+    return _mm256_permute4x64_epi64(_mm256_shuffle_epi8(x, rev), 0x4E);
+}
+#elif defined(__SSE2__)
+static inline __m128i foldCase128(__m128i x) {
+    __m128i upper = bytesInRange(x, 'A', 'Z');
+    return _mm_or_si128(x, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+static inline __m128i reverseBytes128(__m128i x) {
+#if defined(__SSSE3__)
+    return _mm_shuffle_epi8(x, _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+#else
+    // reverse the 4 dwords, then the 2 words inside each dword, then the
+    // 2 bytes inside each word
+    x = _mm_shuffle_epi32(x, 0x1B);
+    x = _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xB1), 0xB1);
+    return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+#endif
+}
+#endif
+
+// Keeps only [0-9A-Za-z] bytes; returns the number written to out (out needs len bytes + 8 slack)
+static size_t compactAlnum(const unsigned char *buf, size_t len, unsigned char *out) {
+    size_t written = 0;
+    size_t i = 0;
+#if defined(__SSSE3__)
+    for (; i + 16 <= len; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + i));
+        __m128i lower = _mm_or_si128(x, _mm_set1_epi8(0x20));
+        __m128i keep = _mm_or_si128(bytesInRange(x, '0', '9'), bytesInRange(lower, 'a', 'z'));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(keep));
+
+        // low 8 bytes
+        __m128i idxLo = _mm_cvtsi64_si128(static_cast<long long>(kCompactTable.shuffle[mask & 0xFF]));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + written), _mm_shuffle_epi8(x, idxLo));
+        written += static_cast<size_t>(__builtin_popcount(mask & 0xFF));
+
+        // high 8 bytes (shift them down first, then reuse the same table)
+        __m128i high = _mm_srli_si128(x, 8);
+        __m128i idxHi = _mm_cvtsi64_si128(static_cast<long long>(kCompactTable.shuffle[mask >> 8]));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + written), _mm_shuffle_epi8(high, idxHi));
+        written += static_cast<size_t>(__builtin_popcount(mask >> 8));
+    }
+#endif
+    for (; i < len; i++) {
+        if (isAsciiAlnum(buf[i])) {
+            out[written++] = buf[i];
+        }
+    }
+    return written;
+}
+
+static bool compareReversed(const unsigned char *buf, size_t len, bool foldCase) {
+    size_t lo = 0;
+    size_t hi = len; // one past the last byte still to check
+
+#if defined(__AVX2__)
+    while (hi - lo >= 64) {
+        __m256i front = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(buf + lo));
+        __m256i back = reverseBytes256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(buf + hi - 32)));
+        if (foldCase) {
+            front = foldCase256(front);
+            back = foldCase256(back);
+        }
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(front, back)) != -1) {
+            return false;
+        }
+        lo += 32;
+        hi -= 32;
+    }
+#elif defined(__SSE2__)
+    while (hi - lo >= 32) {
+        __m128i front = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + lo));
+        __m128i back = reverseBytes128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + hi - 16)));
+        if (foldCase) {
+            front = foldCase128(front);
+            back = foldCase128(back);
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(front, back)) != 0xFFFF) {
+            return false;
+        }
+        lo += 16;
+        hi -= 16;
+    }
+#endif
+
+    // scalar tail: same two-pointer loop as Helper 1
+    while (hi - lo >= 2) {
+        unsigned char a = buf[lo];
+        unsigned char b = buf[hi - 1];
+        if (foldCase) {
+            a = foldAsciiCase(a);
+            b = foldAsciiCase(b);
+        }
+        if (a != b) {
+            return false;
+        }
+        lo++;
+        hi--;
+    }
+    return true;
+}
+
+bool checkPalindromeFast(const char buf[], size_t len, unsigned mode = kPalindromeExact) {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(buf);
+    const bool foldCase = (mode & kPalindromeFoldCase) != 0u;
+
+    if ((mode & kPalindromeAlnumOnly) == 0u) {
+        return compareReversed(bytes, len, foldCase);
+    }
+
+    std::vector<unsigned char> kept(len + 8); // +8: compaction stores whole 8-byte groups
+    size_t keptLen = compactAlnum(bytes, len, kept.data());
+    return compareReversed(kept.data(), keptLen, foldCase);
+}
+
+/* ============================================================================
+   Helper 4: Finding palindromic REGIONS in large inputs (Manacher, streamed)
+   Why:
+     - Helpers 1-3 only answer "is the WHOLE buffer a palindrome?".
+     - For text / sequence files we want "where are the palindromes?":
+         the longest one, or every maximal one above a length threshold.
+   Manacher's algorithm (O(n)):
+     - d1[i] = radius of the longest odd palindrome centred at i
+               (covers [i-d1+1 .. i+d1-1], length 2*d1-1)
+     - d2[i] = radius of the longest even palindrome centred between i-1 and i
+               (covers [i-d2 .. i+d2-1], length 2*d2)
+     - It reuses the mirror of i inside the right-most palindrome seen so far
+       (box [l..r]) as a starting radius, so the total extension work is O(n).
+   Streaming with bounded overlap:
+     - The input is split into chunks of chunkSize bytes. Each chunk "owns" the
+       centres inside it.
+     - Manacher runs on a window = chunk + maxLength bytes of overlap on each side,
+       so any palindrome up to 2*maxLength+1 bytes with an owned centre is seen whole.
+     - Longer palindromes get clipped at the window edge; they are still reported
+       but with truncated = true (their length is a lower bound).
+     - Memory is O(chunkSize + 2*maxLength) no matter how big the input is.
+   Large files:
+     - MappedFile maps the file read-only (mmap), so a gigabyte file is never
+       copied into a char[]; the kernel pages it in as the windows move forward.
+   ========================================================================== */
+struct PalindromeMatch {
+    uint64_t offset;   // first byte of the palindrome in the input
+    uint64_t length;   // number of bytes
+    bool truncated;    // clipped by the overlap window; true length may be longer
+};
+
+struct PalindromeScanOptions {
+    size_t chunkSize = 1u << 20;   // centres owned per window
+    size_t maxLength = 1u << 16;   // overlap on each side of a chunk
+    uint64_t minLength = 2;        // report only palindromes at least this long
+    bool reportAll = false;        // false: longest only, true: every maximal one
+};
+
+static void manacherWindow(const unsigned char *w, size_t m,
+                           std::vector<int32_t> &d1, std::vector<int32_t> &d2) {
+    d1.resize(m);
+    d2.resize(m);
+
+    // odd lengths
+    for (long i = 0, l = 0, r = -1; i < static_cast<long>(m); i++) {
+        long k = (i > r) ? 1 : std::min<long>(d1[l + r - i], r - i + 1);
+        while (i - k >= 0 && i + k < static_cast<long>(m) && w[i - k] == w[i + k]) {
+            k++;
+        }
+        d1[i] = static_cast<int32_t>(k);
+        if (i + k - 1 > r) {
+            l = i - k + 1;
+            r = i + k - 1;
+        }
+    }
+
+    // even lengths
+    for (long i = 0, l = 0, r = -1; i < static_cast<long>(m); i++) {
+        long k = (i > r) ? 0 : std::min<long>(d2[l + r - i + 1], r - i + 1);
+        while (i - k - 1 >= 0 && i + k < static_cast<long>(m) && w[i - k - 1] == w[i + k]) {
+            k++;
+        }
+        d2[i] = static_cast<int32_t>(k);
+        if (i + k - 1 > r) {
+            l = i - k;
+            r = i + k - 1;
+        }
+    }
+}
+
+// Scans data[0..len) and returns the longest palindrome (length 0 if none >= minLength).
+// With reportAll, onMatch is called for every maximal palindrome >= minLength, in centre order.
+PalindromeMatch findPalindromes(const char data[], uint64_t len, const PalindromeScanOptions &options,
+                                const std::function<void(const PalindromeMatch &)> &onMatch = nullptr) {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+    const uint64_t chunk = std::max<uint64_t>(options.chunkSize, 1u);
+    const uint64_t overlap = options.maxLength;
+
+    PalindromeMatch longest = {0, 0, false};
+    std::vector<int32_t> d1;
+    std::vector<int32_t> d2;
+
+    for (uint64_t ownStart = 0; ownStart < len; ownStart += chunk) {
+        const uint64_t ownEnd = std::min(len, ownStart + chunk);
+        const uint64_t winStart = (ownStart > overlap) ? ownStart - overlap : 0;
+        const uint64_t winEnd = std::min(len, ownEnd + overlap);
+        const size_t m = static_cast<size_t>(winEnd - winStart);
+
+        manacherWindow(bytes + winStart, m, d1, d2);
+
+        auto consider = [&](uint64_t left, uint64_t right) { // window-relative, right exclusive
+            PalindromeMatch match;
+            match.offset = winStart + left;
+            match.length = right - left;
+            match.truncated = (left == 0 && winStart > 0) || (right == m && winEnd < len);
+            if (match.length < options.minLength) {
+                return;
+            }
+            if (match.length > longest.length) {
+                longest = match;
+            }
+            if (options.reportAll && onMatch) {
+                onMatch(match);
+            }
+        };
+
+        for (size_t i = static_cast<size_t>(ownStart - winStart); i < static_cast<size_t>(ownEnd - winStart); i++) {
+            if (d2[i] > 0) {
+                consider(i - d2[i], i + d2[i]);
+            }
+            consider(i - d1[i] + 1, i + d1[i]);
+        }
+    }
+    return longest;
+}
+
+/* MappedFile: read-only view of a whole file (mmap on POSIX, plain read elsewhere)
+   - ok() is false if the file could not be opened, stat'ed or mapped
+   - an empty file is ok() with length() 0 (nothing to map) */
+class MappedFile {
+public:
+    explicit MappedFile(const char *path) : bytes(nullptr), size(0), mapped(false), opened(false) {
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == 0) {
+            if (st.st_size == 0) {
+                opened = true;
+            } else {
+                void *p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+                    bytes = static_cast<const char *>(p);
+                    size = static_cast<uint64_t>(st.st_size);
+                    mapped = true;
+                    opened = true;
+                }
+            }
+        }
+        close(fd);
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return;
+        }
+        fallback.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        bytes = fallback.data();
+        size = fallback.size();
+        opened = true;
+#endif
+    }
+
+    ~MappedFile() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (mapped) {
+            munmap(const_cast<char *>(bytes), static_cast<size_t>(size));
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool ok() const { return opened; }
+    const char *data() const { return bytes; }
+    uint64_t length() const { return size; }
+
+private:
+    const char *bytes;
+    uint64_t size;
+    bool mapped;
+    bool opened;
+    std::vector<char> fallback;
+};
+
+int main(int argc, char *argv[]) {
 
     /* =========================================================================
        EX: Palindrome checking demo (iterative + recursive)
@@ -127,5 +529,61 @@ int main() {
     result = checkPalindrome(str2, size2);
     cout << "Iterative check for " << str2 << " -> " << (result ? "palindrome" : "not a palindrome") << endl;
 
+    /* =========================================================================
+       EX: Vectorised palindrome kernel (long buffers + filtering modes)
+       - checkPalindromeFast takes a length, not sizeof (no '\0' counted).
+       ======================================================================= */
+    const char sentence[] = "A man, a plan, a canal: Panama";
+    size_t sentenceLen = sizeof(sentence) - 1;
+    cout << "Exact     : " << (checkPalindromeFast(sentence, sentenceLen) ? "palindrome" : "not a palindrome") << endl;
+    cout << "Alnum+Fold: "
+         << (checkPalindromeFast(sentence, sentenceLen, kPalindromeAlnumOnly | kPalindromeFoldCase)
+                 ? "palindrome" : "not a palindrome") << endl;
+
+    // 3 MB palindrome: mirror a pseudo-random first half, then break one byte
+    const size_t bigLen = 3u * 1024u * 1024u + 7u;
+    std::vector<char> big(bigLen);
+    unsigned seed = 12345u;
+    for (size_t i = 0; i < (bigLen + 1) / 2; i++) {
+        seed = seed * 1103515245u + 12345u;
+        big[i] = static_cast<char>('a' + (seed >> 16) % 26);
+        big[bigLen - 1 - i] = big[i];
+    }
+    bool bigOk = checkPalindromeFast(big.data(), bigLen);
+    big[bigLen / 3] = '#';
+    bool bigBroken = checkPalindromeFast(big.data(), bigLen);
+    cout << "3 MB buffer: " << (bigOk ? "palindrome" : "not a palindrome")
+         << ", after one change: " << (bigBroken ? "palindrome" : "not a palindrome") << endl;
+
+    /* =========================================================================
+       EX: Palindromic regions (Manacher, streamed in windows)
+       - With a file argument: scan the file through mmap and print the longest.
+       - Without: demo on a small buffer with tiny chunks so overlap is exercised.
+       ======================================================================= */
+    PalindromeScanOptions options;
+    if (argc > 1) {
+        MappedFile file(argv[1]);
+        if (!file.ok()) {
+            cout << "Error: cannot open " << argv[1] << endl;
+            return 1;
+        }
+        PalindromeMatch best = findPalindromes(file.data(), file.length(), options);
+        cout << "Longest palindrome in " << argv[1] << ": offset " << best.offset
+             << ", length " << best.length << (best.truncated ? " (truncated)" : "") << endl;
+        return 0;
+    }
+
+    const char text[] = "xxabacabaxyzracecarqqlevelq";
+    options.chunkSize = 4;
+    options.maxLength = 8;
+    options.minLength = 5;
+    options.reportAll = true;
+    PalindromeMatch best = findPalindromes(text, sizeof(text) - 1, options,
+        [&text](const PalindromeMatch &m) {
+            cout << "  found \"" << std::string(text + m.offset, static_cast<size_t>(m.length)) << "\" at "
+                 << m.offset << (m.truncated ? " (truncated)" : "") << endl;
+        });
+    cout << "Longest: \"" << std::string(text + best.offset, static_cast<size_t>(best.length)) << "\"" << endl;
+
     return 0;
 }
@@ -1,6 +1,14 @@
 
 
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 using std::cout;
 using std::endl;
@@ -34,10 +42,488 @@ int linearSearchRecursive(int arr[], int start, int end, int key)
 
   return (linearSearchRecursive(arr, start + 1, end,key));
 }
+
+/*
+  Linear Search SIMD : same contract as linearSearch (1-based position or -1)
+  - AVX2 compares 8 ints per instruction; the main loop checks 32 ints
+    (4 compares OR-ed together) and only looks for the lane on a hit.
+  - movemask turns the compare result into a bit per lane, ctz gives the first hit.
+  - Falls back to SSE2 (4 ints) and then to the plain loop for the tail.
+*/
+
+int linearSearchSimd(const int arr[], int arrSize, int key)
+{
+  int i = 0;
+
+#if defined(__AVX2__)
+  const __m256i needle = _mm256_set1_epi32(key);
+
+  for (; i + 32 <= arrSize; i += 32)
+  {
+    const __m256i *p = reinterpret_cast<const __m256i *>(arr + i);
+    __m256i eq0 = _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 0), needle);
+    __m256i eq1 = _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 1), needle);
+    __m256i eq2 = _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 2), needle);
+    __m256i eq3 = _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 3), needle);
+    __m256i any = _mm256_or_si256(_mm256_or_si256(eq0, eq1), _mm256_or_si256(eq2, eq3));
+
+    if (!_mm256_testz_si256(any, any))
+    {
+      break; // the 8-wide loop below finds the exact lane
+    }
+  }
+
+  for (; i + 8 <= arrSize; i += 8)
+  {
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(arr + i));
+    int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(block, needle)));
+    if (mask != 0)
+    {
+      return i + __builtin_ctz(static_cast<unsigned>(mask)) + 1;
+    }
+  }
+#elif defined(__SSE2__)
+  const __m128i needle = _mm_set1_epi32(key);
+
+  for (; i + 4 <= arrSize; i += 4)
+  {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(arr + i));
+    int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, needle)));
+    if (mask != 0)
+    {
+      return i + __builtin_ctz(static_cast<unsigned>(mask)) + 1;
+    }
+  }
+#endif
+
+  for (; i < arrSize; i++)
+  {
+    if (arr[i] == key)
+    {
+      return i + 1;
+    }
+  }
+  return -1;
+}
+
+/*
+  Search Index : for repeated lookups on an array that does not change
+  - Scan      : no index, every query is linearSearchSimd (cheap when queries are few)
+  - Eytzinger : sorted copy stored in BFS (heap) order, branchless descent
+                k = 2k + (tree[k] < key), prefetching the grandchildren
+  - Hash      : static open-addressing table key -> first position (O(1) query)
+
+  Every mode returns the same answer as linearSearch: the FIRST position of key.
+  For duplicates the sorted copy is ordered by (value, position), so the lower
+  bound lands on the smallest position.
+
+  chooseSearchMode picks the mode from the expected number of queries:
+  - a SIMD scan costs ~n/8 per query, building an index at least ~n
+    (the hash table; the sorted copy is ~n*log2(n))
+  - so scanning wins while queries < 8*log2(n); past that the hash index
+    is both cheaper to build and cheaper to query, so it is the only
+    index picked automatically
+  - Eytzinger is there to ask for by hand: 2*(n+1) ints instead of the
+    hash table's 2*capacity (capacity 2n..4n), i.e. 2-4x less memory
+*/
+
+enum class SearchMode { Scan, Eytzinger, Hash };
+
+SearchMode chooseSearchMode(int arrSize, long long expectedQueries)
+{
+  int log2n = 1;
+  while ((1LL << log2n) < arrSize)
+  {
+    log2n++;
+  }
+
+  if (arrSize < 64 || expectedQueries < 8LL * log2n)
+  {
+    return SearchMode::Scan;
+  }
+  return SearchMode::Hash;
+}
+
+class LinearSearchIndex
+{
+public:
+  LinearSearchIndex(const int arr[], int arrSize, long long expectedQueries)
+    : LinearSearchIndex(arr, arrSize, chooseSearchMode(arrSize, expectedQueries))
+  {
+  }
+
+  LinearSearchIndex(const int arr[], int arrSize, SearchMode mode)
+    : data(arr), size(arrSize), searchMode(mode), hashMask(0)
+  {
+    if (searchMode == SearchMode::Eytzinger)
+    {
+      buildEytzinger();
+    }
+    else if (searchMode == SearchMode::Hash)
+    {
+      buildHash();
+    }
+  }
+
+  SearchMode mode() const { return searchMode; }
+
+  // 1-based position of the first occurrence of key, or -1
+  int find(int key) const
+  {
+    switch (searchMode)
+    {
+      case SearchMode::Eytzinger: return findEytzinger(key);
+      case SearchMode::Hash:      return findHash(key);
+      default:                    return linearSearchSimd(data, size, key);
+    }
+  }
+
+private:
+  const int *data;   // caller-owned, must outlive the index
+  int size;
+  SearchMode searchMode;
+
+  // Eytzinger layout: slot 0 unused, children of k are 2k and 2k+1
+  std::vector<int> treeKey;
+  std::vector<int> treePos;
+
+  // Hash layout: capacity is a power of two, slotPos == -1 means empty
+  std::vector<int> slotKey;
+  std::vector<int> slotPos;
+  uint32_t hashMask;
+
+  static uint32_t hashOf(int key)
+  {
+    return static_cast<uint32_t>(key) * 0x9E3779B1u; // Fibonacci hashing
+  }
+
+  void buildEytzinger()
+  {
+    std::vector<std::pair<int, int>> sorted(size);
+    for (int i = 0; i < size; i++)
+    {
+      sorted[i] = std::make_pair(data[i], i + 1);
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    treeKey.assign(size + 1, 0);
+    treePos.assign(size + 1, -1);
+
+    // in-order walk of the implicit tree assigns sorted values to BFS slots
+    int next = 0;
+    std::vector<int> stack;
+    int k = 1;
+    while (k <= size || !stack.empty())
+    {
+      while (k <= size)
+      {
+        stack.push_back(k);
+        k = 2 * k;
+      }
+      k = stack.back();
+      stack.pop_back();
+      treeKey[k] = sorted[next].first;
+      treePos[k] = sorted[next].second;
+      next++;
+      k = 2 * k + 1;
+    }
+  }
+
+  int findEytzinger(int key) const
+  {
+    const int *tree = treeKey.data();
+    int k = 1;
+    while (k <= size)
+    {
+      __builtin_prefetch(tree + 4 * k);
+      k = 2 * k + (tree[k] < key);
+    }
+    // undo the trailing "went right" steps to land on the lower bound
+    k >>= __builtin_ffs(~k);
+
+    if (k == 0 || tree[k] != key)
+    {
+      return -1;
+    }
+    return treePos[k];
+  }
+
+  void buildHash()
+  {
+    // size_t: 2 * size no longer fits uint32_t past 2^31 and the loop
+    // would wrap to 0; capacity tops out at 2^32, so the mask still fits
+    size_t capacity = 16;
+    while (capacity < 2 * static_cast<size_t>(size))
+    {
+      capacity <<= 1;
+    }
+    hashMask = static_cast<uint32_t>(capacity - 1);
+    slotKey.assign(capacity, 0);
+    slotPos.assign(capacity, -1);
+
+    for (int i = 0; i < size; i++)
+    {
+      uint32_t slot = (hashOf(data[i]) >> 7) & hashMask;
+      while (slotPos[slot] != -1 && slotKey[slot] != data[i])
+      {
+        slot = (slot + 1) & hashMask;
+      }
+      if (slotPos[slot] == -1)
+      {
+        slotKey[slot] = data[i];
+        slotPos[slot] = i + 1; // keep the first occurrence only
+      }
+    }
+  }
+
+  int findHash(int key) const
+  {
+    uint32_t slot = (hashOf(key) >> 7) & hashMask;
+    while (slotPos[slot] != -1)
+    {
+      if (slotKey[slot] == key)
+      {
+        return slotPos[slot];
+      }
+      slot = (slot + 1) & hashMask;
+    }
+    return -1;
+  }
+};
+
+/*
+  Batch Search : many keys against the same array in ONE pass
+  - linearSearch answers one key per full pass, so K keys cost K passes.
+  - Here the keys go into a KeySet first, then the array is scanned once and
+    every element is tested for membership (every (key, position) pair is reported,
+    not only the first one).
+  - KeySet is a bitset over [minKey..maxKey] when that range is small, otherwise
+    a small open-addressing hash set. The [minKey..maxKey] range check runs first
+    and rejects most elements without touching the table.
+  - The array is split into chunks, one per thread. Each thread collects its hits
+    locally; chunks are copied out in order, so hits come out sorted by position.
+
+  Output contract:
+  - hits[] is caller-supplied with room for hitCapacity entries
+  - positions are 1-based like linearSearch
+  - returns the TOTAL number of hits; if it is larger than hitCapacity, only the
+    first hitCapacity hits were written (caller can detect truncation)
+*/
+
+struct SearchHit
+{
+  int key;
+  int position;
+};
+
+class KeySet
+{
+public:
+  KeySet(const int keys[], int keyCount)
+    : minKey(0), range(0), useBits(false), mask(0)
+  {
+    if (keyCount <= 0)
+    {
+      useBits = true;     // empty set: a single all-zero word never matches
+      bits.assign(1, 0);
+      return;
+    }
+
+    int lo = keys[0];
+    int hi = keys[0];
+    for (int i = 1; i < keyCount; i++)
+    {
+      lo = std::min(lo, keys[i]);
+      hi = std::max(hi, keys[i]);
+    }
+    minKey = lo;
+    range = static_cast<uint32_t>(hi) - static_cast<uint32_t>(lo);
+
+    // a bitset of up to 4M bits (512 KB) beats hashing for dense key ranges
+    if (range < (1u << 22))
+    {
+      useBits = true;
+      bits.assign(range / 64 + 1, 0);
+      for (int i = 0; i < keyCount; i++)
+      {
+        uint32_t off = static_cast<uint32_t>(keys[i]) - static_cast<uint32_t>(minKey);
+        bits[off / 64] |= (1ULL << (off % 64));
+      }
+      return;
+    }
+
+    // size_t for the same reason as LinearSearchIndex::buildHash
+    size_t capacity = 16;
+    while (capacity < 2 * static_cast<size_t>(keyCount))
+    {
+      capacity <<= 1;
+    }
+    mask = static_cast<uint32_t>(capacity - 1);
+    slotKey.assign(capacity, 0);
+    slotUsed.assign(capacity, 0);
+    for (int i = 0; i < keyCount; i++)
+    {
+      uint32_t slot = slotOf(keys[i]);
+      while (slotUsed[slot] && slotKey[slot] != keys[i])
+      {
+        slot = (slot + 1) & mask;
+      }
+      slotKey[slot] = keys[i];
+      slotUsed[slot] = 1;
+    }
+  }
+
+  bool contains(int value) const
+  {
+    uint32_t off = static_cast<uint32_t>(value) - static_cast<uint32_t>(minKey);
+    if (off > range)
+    {
+      return false;
+    }
+    if (useBits)
+    {
+      return (bits[off / 64] >> (off % 64)) & 1ULL;
+    }
+    uint32_t slot = slotOf(value);
+    while (slotUsed[slot])
+    {
+      if (slotKey[slot] == value)
+      {
+        return true;
+      }
+      slot = (slot + 1) & mask;
+    }
+    return false;
+  }
+
+private:
+  int minKey;
+  uint32_t range;      // maxKey - minKey (as unsigned, so wide ranges do not overflow)
+  bool useBits;
+  std::vector<uint64_t> bits;
+  std::vector<int> slotKey;
+  std::vector<unsigned char> slotUsed;
+  uint32_t mask;
+
+  uint32_t slotOf(int key) const
+  {
+    return ((static_cast<uint32_t>(key) * 0x9E3779B1u) >> 7) & mask;
+  }
+};
+
+int linearSearchBatch(const int arr[], int arrSize, const int keys[], int keyCount,
+                      SearchHit hits[], int hitCapacity, int threadCount = 0)
+{
+  const KeySet keySet(keys, keyCount);
+
+  if (threadCount <= 0)
+  {
+    threadCount = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  // keep chunks big enough that thread start-up is noise next to the scan
+  const int kMinChunk = 1 << 16;
+  threadCount = std::max(1, std::min(threadCount, arrSize / kMinChunk));
+
+  std::vector<std::vector<SearchHit>> chunkHits(threadCount);
+  auto scanChunk = [&](int t)
+  {
+    int start = static_cast<int>(static_cast<long long>(arrSize) * t / threadCount);
+    int end = static_cast<int>(static_cast<long long>(arrSize) * (t + 1) / threadCount);
+    std::vector<SearchHit> &local = chunkHits[t];
+    for (int i = start; i < end; i++)
+    {
+      if (keySet.contains(arr[i]))
+      {
+        local.push_back(SearchHit{arr[i], i + 1});
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (int t = 1; t < threadCount; t++)
+  {
+    workers.emplace_back(scanChunk, t);
+  }
+  scanChunk(0);
+  for (std::thread &w : workers)
+  {
+    w.join();
+  }
+
+  int total = 0;
+  for (const std::vector<SearchHit> &local : chunkHits)
+  {
+    for (const SearchHit &hit : local)
+    {
+      if (total < hitCapacity)
+      {
+        hits[total] = hit;
+      }
+      total++;
+    }
+  }
+  return total;
+}
+
 int main() {
 
     int arr[] = {1,2,3,4,5,6,7,8,9};
     int key = 9;
     cout << "The key " << key << " is preset in array at index " << linearSearchRecursive(arr, 0,9, key) << endl;
+
+    // SIMD scan + search index on a larger array with duplicates
+    const int bigSize = 100000;
+    std::vector<int> big(bigSize);
+    for (int i = 0; i < bigSize; i++)
+    {
+      big[i] = (i * 7919) % 50021; // values repeat, so first-occurrence matters
+    }
+
+    LinearSearchIndex byScan(big.data(), bigSize, SearchMode::Scan);
+    LinearSearchIndex byTree(big.data(), bigSize, SearchMode::Eytzinger);
+    LinearSearchIndex byHash(big.data(), bigSize, SearchMode::Hash);
+
+    int mismatches = 0;
+    for (int probe = -5; probe < 50100; probe += 3)
+    {
+      int expected = linearSearch(big.data(), bigSize, probe);
+      if (byScan.find(probe) != expected || byTree.find(probe) != expected ||
+          byHash.find(probe) != expected)
+      {
+        mismatches++;
+      }
+    }
+    cout << "Index modes agree with linearSearch: " << (mismatches == 0 ? "yes" : "no") << endl;
+
+    LinearSearchIndex autoIndex(big.data(), bigSize, 1000000LL);
+    cout << "Mode chosen for 1e6 queries: "
+         << (autoIndex.mode() == SearchMode::Hash ? "hash" :
+             autoIndex.mode() == SearchMode::Eytzinger ? "eytzinger" : "scan") << endl;
+    // Batch search: several keys, one pass, all positions
+    int batchArr[] = {5, 3, 9, 3, 7, 5, 1};
+    int batchKeys[] = {3, 5, 42};
+    SearchHit batchHits[8];
+    int hitCount = linearSearchBatch(batchArr, 7, batchKeys, 3, batchHits, 8);
+    cout << "Batch hits (key@position):";
+    for (int i = 0; i < hitCount && i < 8; i++)
+    {
+      cout << " " << batchHits[i].key << "@" << batchHits[i].position;
+    }
+    cout << endl;
+
+    // Batch search agrees with per-key scanning on the big array (wide key range -> hash set)
+    std::vector<int> wideKeys = {0, 17, 49999, 50020, 123456789, -7};
+    std::vector<SearchHit> wideHits(bigSize);
+    int wideCount = linearSearchBatch(big.data(), bigSize, wideKeys.data(),
+                                      static_cast<int>(wideKeys.size()), wideHits.data(), bigSize, 4);
+    int expectedCount = 0;
+    for (int i = 0; i < bigSize; i++)
+    {
+      for (int k : wideKeys)
+      {
+        expectedCount += (big[i] == k);
+      }
+    }
+    cout << "Batch hit count matches per-key scan: " << (wideCount == expectedCount ? "yes" : "no") << endl;
     return 0;
 }
@@ -17,6 +17,7 @@
         - Pointer iteration version (idiomatic C/C++)
         - Production-style (size_t + pointer difference)
         - Bounded length version (strnlen-style; critical for embedded buffers)
+        - Fast versions: word-at-a-time (8 bytes per step) and SIMD (16/32 bytes per step)
 
     2) strcpy-style function:
         - Pointer-based
@@ -31,6 +32,29 @@
         - Explicit NULL policy using assert
         - Demonstration notes: printing result as a C-string can be unsafe if not terminated
 
+    4) Fast copy paths (my_strcpy_fast / my_strncpy_fast):
+        - Same semantics as 2) and 3), but find '\0' with the SIMD scan first,
+          then copy / pad in blocks
+        - Fuzz harness (./a.out --fuzz) checks byte-exact equality with 2) and 3)
+
+    5) Bounded safe copy / concatenate (strlcpy / strlcat-style):
+        - ALWAYS null-terminate (when size > 0), never write past size bytes
+        - Return strlen(src) (or strlen(dest)+strlen(src)) so callers detect truncation
+        - Length scan and copy happen in ONE pass over src
+
+    6) SmallString (owning string for many short strings):
+        - 22 chars stored inline (no allocation), cached length
+        - Optional Arena: bump allocator, everything freed in one reset()
+        - Interop: c_str() feeds the my_* functions, copyTo() uses my_strlcpy
+        - Appending the string to itself (s.append(s)) is safe: the source is
+          re-based when reserve() moves the buffer (checked by --fuzz)
+
+    7) Substring search (memmem / strstr-style) + multi-needle search:
+        - Short needles: SIMD first/last-byte filter, memcmp only on candidates
+        - Long needles: Boyer-Moore-Horspool skip table
+        - Many needles at once: Aho-Corasick automaton (one pass over the text)
+        - MappedFile + ./a.out --grep FILE TOKEN... scans files without copying
+
     IMPORTANT CONCEPTS (carry these everywhere):
     -------------------------------------------
     A) C strings terminate with '\0' (NOT '\n').
@@ -42,7 +66,7 @@
     G) If buffers overlap, strcpy/strncpy are undefined behavior.
     H) If destination is too small, strcpy overflows (unsafe by design).
     I) For embedded buffers that might not be '\0'-terminated, prefer bounded functions
-       (like strnlen) and eventually safe copy patterns (strlcpy-like) for production.
+       (like strnlen) and safe copy patterns (my_strlcpy / my_strlcat below) for production.
 
     NULL policy in this file:
     -------------------------
@@ -58,6 +82,30 @@
 #include <iostream>
 #include <cstddef>   // size_t
 #include <cassert>   // assert
+#include <cstdint>   // uint64_t, uintptr_t
+#include <cstring>   // strlen, strnlen (benchmark baseline)
+#include <chrono>    // benchmark timing
+#include <vector>
+#include <iomanip>   // setw (benchmark table)
+#include <random>    // fuzz harness
+#include <algorithm> // std::search (fuzz reference)
+#include <functional>
+#include <utility>   // std::move
+#include <string>    // SmallString fuzz reference
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
@@ -80,11 +128,25 @@ using namespace std;
        - Either use s[i] and i++
        - Or use *p and p++
     3) Use size_t for lengths in production (avoid signed issues).
+
+    BYTE_LOOP:
+    - GCC recognises the two learning loops below as "strlen" and emits
+      call strlen@plt, which would make the benchmark compare glibc to itself.
+    - noinline + no-tree-loop-distribute-patterns keeps the real byte loop.
 */
 
+#if defined(__GNUC__) && !defined(__clang__)
+#define BYTE_LOOP __attribute__((noinline, optimize("no-tree-loop-distribute-patterns")))
+#elif defined(__clang__)
+#define BYTE_LOOP __attribute__((noinline))
+#else
+#define BYTE_LOOP
+#endif
+
 /* -----------------------------------------------------------
    1) Learning version: Array subscript (review-friendly)
    ----------------------------------------------------------- */
+BYTE_LOOP
 size_t my_strlen_subscript(const char s[])
 {
     if (s == nullptr) {
@@ -101,6 +163,7 @@ size_t my_strlen_subscript(const char s[])
 /* -----------------------------------------------------------
    2) Learning version: Pointer iteration (idiomatic)
    ----------------------------------------------------------- */
+BYTE_LOOP
 size_t my_strlen_pointer(const char *s)
 {
     if (s == nullptr) {
@@ -160,6 +223,229 @@ size_t my_strnlen_prod(const char s[], size_t max_len)
     return i;
 }
 
+/* -----------------------------------------------------------
+   5) Fast versions: scan a word / a vector per step
+   ----------------------------------------------------------- */
+/*
+    Why the loops above are slow on long strings:
+    ---------------------------------------------
+    They test ONE byte per iteration. A 64-bit CPU can test 8 bytes with a
+    few integer ops, and SSE2/AVX2 can test 16/32 bytes with one compare.
+
+    Word-at-a-time ("haszero" bit trick):
+    -------------------------------------
+        haszero(v) = (v - 0x0101010101010101) & ~v & 0x8080808080808080
+    - Non-zero exactly when some byte of v is 0x00.
+    - The LOWEST set bit marks the FIRST zero byte (borrows only create false
+      marks ABOVE a real zero), so on little-endian: index = ctz(mask) / 8.
+
+    SIMD:
+    -----
+    - pcmpeqb compares 16 (SSE2) or 32 (AVX2) bytes against 0 at once.
+    - movemask packs the result into one bit per byte -> ctz gives the index.
+
+    The page-boundary rule (why we ALIGN first):
+    --------------------------------------------
+    - Reading past '\0' is only safe if we never touch a page that might not
+      be mapped.
+    - An ALIGNED 8/16/32-byte load never crosses a page boundary (pages are
+      4096-byte aligned), and it contains at least one byte we were allowed
+      to read -> that page is mapped.
+    - So: round the pointer DOWN to the block size, ignore the bytes before s
+      in the first block, then use aligned loads only.
+    - These over-reads are deliberate (same as libc); they are excluded from
+      AddressSanitizer instrumentation with NO_SANITIZE_OVERREAD.
+
+    Bounded versions (my_strnlen_*):
+    --------------------------------
+    - Same scan, but the result is clamped to max_len, and we stop loading once
+      a block starts at or beyond s + max_len (so we never touch a page that
+      holds none of the max_len bytes).
+*/
+
+#if defined(__GNUC__) || defined(__clang__)
+#define NO_SANITIZE_OVERREAD __attribute__((no_sanitize_address))
+typedef uint64_t __attribute__((may_alias)) aliased_u64;
+#else
+#define NO_SANITIZE_OVERREAD
+typedef uint64_t aliased_u64;
+#endif
+
+static const uint64_t kLowBytes  = 0x0101010101010101ULL;
+static const uint64_t kHighBytes = 0x8080808080808080ULL;
+
+static inline uint64_t haszero(uint64_t v)
+{
+    return (v - kLowBytes) & ~v & kHighBytes;
+}
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+
+/*
+    Scans aligned 8-byte words starting with the one that holds s.
+    Returns the offset of the first '\0' from s, or limit if none is found in
+    the words that start before s + limit (limit = SIZE_MAX means unbounded).
+*/
+NO_SANITIZE_OVERREAD
+static size_t scan_zero_word(const char *s, size_t limit)
+{
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(s);
+    const size_t misalign = addr & 7U;
+    const aliased_u64 *w = reinterpret_cast<const aliased_u64 *>(addr - misalign);
+
+    // Force the bytes before s to be non-zero so they can't match
+    uint64_t v = *w | ((misalign == 0U) ? 0U : (~0ULL >> (64U - 8U * misalign)));
+    size_t base = 0U;   // offset (from the aligned start) of the current word
+
+    for (;;) {
+        const uint64_t mask = haszero(v);
+        if (mask != 0U) {
+            const size_t found = base + (static_cast<size_t>(__builtin_ctzll(mask)) >> 3) - misalign;
+            return (found < limit) ? found : limit;
+        }
+        base += 8U;
+        if (base - misalign >= limit) {
+            return limit;
+        }
+        v = *++w;
+    }
+}
+
+#if defined(__AVX2__)
+static const size_t kVecBytes = 32U;
+
+NO_SANITIZE_OVERREAD
+static inline unsigned zero_mask_aligned(const char *p)
+{
+    const __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i *>(p));
+    return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_setzero_si256())));
+}
+#elif defined(__SSE2__)
+static const size_t kVecBytes = 16U;
+
+NO_SANITIZE_OVERREAD
+static inline unsigned zero_mask_aligned(const char *p)
+{
+    const __m128i v = _mm_load_si128(reinterpret_cast<const __m128i *>(p));
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())));
+}
+#endif
+
+#if defined(__SSE2__)
+/*
+    Same contract as scan_zero_word, with aligned 16/32-byte vectors.
+    Once the pointer is aligned to a group of 4 vectors, the loop tests the
+    whole group per step: pminub folds the 4 vectors into one (a byte is 0 in
+    the minimum iff it is 0 in one of them), so there is one compare + one
+    movemask per 64/128 bytes. A 4-vector-aligned group never crosses a page.
+*/
+static const size_t kGroupBytes = 4U * kVecBytes;
+
+#if defined(__AVX2__)
+NO_SANITIZE_OVERREAD
+static inline bool group_has_zero(const char *p)
+{
+    const __m256i *v = reinterpret_cast<const __m256i *>(p);
+    const __m256i m = _mm256_min_epu8(_mm256_min_epu8(_mm256_load_si256(v), _mm256_load_si256(v + 1)),
+                                      _mm256_min_epu8(_mm256_load_si256(v + 2), _mm256_load_si256(v + 3)));
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi8(m, _mm256_setzero_si256())) != 0;
+}
+#else
+NO_SANITIZE_OVERREAD
+static inline bool group_has_zero(const char *p)
+{
+    const __m128i *v = reinterpret_cast<const __m128i *>(p);
+    const __m128i m = _mm_min_epu8(_mm_min_epu8(_mm_load_si128(v), _mm_load_si128(v + 1)),
+                                   _mm_min_epu8(_mm_load_si128(v + 2), _mm_load_si128(v + 3)));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(m, _mm_setzero_si128())) != 0;
+}
+#endif
+
+NO_SANITIZE_OVERREAD
+static size_t scan_zero_simd(const char *s, size_t limit)
+{
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(s);
+    const size_t misalign = addr & (kVecBytes - 1U);
+    const char *p = s - misalign;
+
+    // Drop the bits of the bytes that come before s
+    unsigned mask = zero_mask_aligned(p) >> misalign;
+    if (mask != 0U) {
+        const size_t found = static_cast<size_t>(__builtin_ctz(mask));
+        return (found < limit) ? found : limit;
+    }
+
+    size_t base = kVecBytes - misalign;   // offset (from s) of the next aligned block
+
+    for (;;) {
+        if (base >= limit) {
+            return limit;
+        }
+        // single vectors until group-aligned, and to locate the '\0' inside a hit group
+        if (((addr + base) & (kGroupBytes - 1U)) != 0U || group_has_zero(s + base)) {
+            mask = zero_mask_aligned(s + base);
+            if (mask != 0U) {
+                const size_t found = base + static_cast<size_t>(__builtin_ctz(mask));
+                return (found < limit) ? found : limit;
+            }
+            base += kVecBytes;
+        } else {
+            base += kGroupBytes;
+        }
+    }
+}
+#endif
+
+#endif // little-endian
+
+size_t my_strlen_word(const char *s)
+{
+    if (s == nullptr) {
+        return 0U;
+    }
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    return scan_zero_word(s, SIZE_MAX);
+#else
+    return my_strlen_prod(s);
+#endif
+}
+
+size_t my_strnlen_word(const char s[], size_t max_len)
+{
+    if (s == nullptr || max_len == 0U) {
+        return 0U;
+    }
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    return scan_zero_word(s, max_len);
+#else
+    return my_strnlen_prod(s, max_len);
+#endif
+}
+
+size_t my_strlen_simd(const char *s)
+{
+    if (s == nullptr) {
+        return 0U;
+    }
+#if defined(__SSE2__)
+    return scan_zero_simd(s, SIZE_MAX);
+#else
+    return my_strlen_word(s);
+#endif
+}
+
+size_t my_strnlen_simd(const char s[], size_t max_len)
+{
+    if (s == nullptr || max_len == 0U) {
+        return 0U;
+    }
+#if defined(__SSE2__)
+    return scan_zero_simd(s, max_len);
+#else
+    return my_strnlen_word(s, max_len);
+#endif
+}
+
 /* ===========================================================
    STRCPY
    =========================================================== */
@@ -286,6 +572,904 @@ char * my_strncpy(char *dest, const char *src, size_t n)
     return start;
 }
 
+/* ===========================================================
+   FAST COPY PATHS (same semantics as my_strcpy / my_strncpy)
+   =========================================================== */
+
+/*
+    Why the reference versions are slow:
+    ------------------------------------
+    - my_strcpy tests and copies one byte per iteration.
+    - my_strncpy additionally branches between copy mode and pad mode per byte.
+
+    Fast approach (two simple steps instead of one clever loop):
+    ------------------------------------------------------------
+    1) Find the length with the SIMD scan (my_strlen_simd / my_strnlen_simd).
+       The scan never reads past a page holding the terminator (see section 5).
+    2) Copy the known number of bytes with block copies:
+         - 32/16/8/4-byte unaligned loads and stores
+         - the LAST block is allowed to OVERLAP the previous one, so any length
+           >= block size is covered without a byte-by-byte tail
+           e.g. 13 bytes = bytes [0..8) + bytes [5..13)
+       Overlapping stores write some bytes twice with the same value: harmless.
+    3) my_strncpy_fast pads the rest of n with a block memset of zeros.
+
+    Rules kept from the reference versions:
+    ---------------------------------------
+    - my_strcpy_fast copies the '\0' exactly once, returns dest.
+    - my_strncpy_fast writes EXACTLY n bytes, no '\0' if strlen(src) >= n.
+    - Overlapping buffers remain undefined behavior (we do not check).
+    - src is read only up to its terminator (or n bytes) - the block copy never
+      reads source bytes beyond the ones being copied.
+*/
+
+#if defined(__AVX2__)
+typedef __m256i copy_vec;
+static const size_t kCopyVec = 32U;
+static inline copy_vec load_vec(const char *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+static inline void store_vec(char *p, copy_vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+#elif defined(__SSE2__)
+typedef __m128i copy_vec;
+static const size_t kCopyVec = 16U;
+static inline copy_vec load_vec(const char *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+static inline void store_vec(char *p, copy_vec v) { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+#endif
+
+static inline void copy_block(char *dest, const char *src, size_t len)
+{
+#if defined(__SSE2__)
+    const size_t V = kCopyVec;
+    if (len >= V) {
+        // up to 4 vectors: fixed head + tail stores (no loop, fewer mispredicts
+        // when lengths vary from call to call)
+        if (len <= 2U * V) {
+            const copy_vec head = load_vec(src);
+            const copy_vec tail = load_vec(src + len - V);
+            store_vec(dest, head);
+            store_vec(dest + len - V, tail);
+            return;
+        }
+        if (len <= 4U * V) {
+            const copy_vec h0 = load_vec(src);
+            const copy_vec h1 = load_vec(src + V);
+            const copy_vec t0 = load_vec(src + len - 2U * V);
+            const copy_vec t1 = load_vec(src + len - V);
+            store_vec(dest, h0);
+            store_vec(dest + V, h1);
+            store_vec(dest + len - 2U * V, t0);
+            store_vec(dest + len - V, t1);
+            return;
+        }
+        const copy_vec tail = load_vec(src + len - V);
+        for (size_t i = 0U; i + V < len; i += V) {
+            store_vec(dest + i, load_vec(src + i));
+        }
+        store_vec(dest + len - V, tail);
+        return;
+    }
+#if defined(__AVX2__)
+    if (len >= 16U) {
+        const __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + len - 16U));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dest), head);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dest + len - 16U), tail);
+        return;
+    }
+#endif
+#endif
+    if (len >= 8U) {
+        uint64_t head = 0U;
+        uint64_t tail = 0U;
+        memcpy(&head, src, 8U);              // compiles to one unaligned load
+        memcpy(&tail, src + len - 8U, 8U);
+        size_t i = 8U;
+        for (; i + 8U < len; i += 8U) {      // only reached without SSE2
+            uint64_t mid = 0U;
+            memcpy(&mid, src + i, 8U);
+            memcpy(dest + i, &mid, 8U);
+        }
+        memcpy(dest, &head, 8U);
+        memcpy(dest + len - 8U, &tail, 8U);
+        return;
+    }
+    if (len >= 4U) {
+        uint32_t head = 0U;
+        uint32_t tail = 0U;
+        memcpy(&head, src, 4U);
+        memcpy(&tail, src + len - 4U, 4U);
+        memcpy(dest, &head, 4U);
+        memcpy(dest + len - 4U, &tail, 4U);
+        return;
+    }
+    for (size_t i = 0U; i < len; ++i) {
+        dest[i] = src[i];
+    }
+}
+
+static inline void zero_block(char *dest, size_t len)
+{
+#if defined(__AVX2__)
+    if (len >= 32U) {
+        const __m256i zero = _mm256_setzero_si256();
+        for (size_t i = 0U; i + 32U < len; i += 32U) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i), zero);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + len - 32U), zero);
+        return;
+    }
+#endif
+#if defined(__SSE2__)
+    if (len >= 16U) {
+        const __m128i zero = _mm_setzero_si128();
+        for (size_t i = 0U; i + 16U < len; i += 16U) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i), zero);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dest + len - 16U), zero);
+        return;
+    }
+#endif
+    if (len >= 8U) {
+        const uint64_t zero = 0U;
+        for (size_t i = 0U; i + 8U < len; i += 8U) {
+            memcpy(dest + i, &zero, 8U);
+        }
+        memcpy(dest + len - 8U, &zero, 8U);
+        return;
+    }
+    for (size_t i = 0U; i < len; ++i) {
+        dest[i] = '\0';
+    }
+}
+
+char * my_strcpy_fast(char *dest, const char *src)
+{
+    assert(dest != nullptr && src != nullptr);
+
+    copy_block(dest, src, my_strlen_simd(src) + 1U);   // +1: the '\0'
+    return dest;
+}
+
+char * my_strncpy_fast(char *dest, const char *src, size_t n)
+{
+    assert(dest != nullptr && src != nullptr);
+
+    // copied = strlen(src) if that is < n, else n (then there is no '\0' to copy)
+    const size_t copied = my_strnlen_simd(src, n);
+    copy_block(dest, src, copied);
+    zero_block(dest + copied, n - copied);   // pad mode, including the terminator
+    return dest;
+}
+
+/* ===========================================================
+   STRLCPY / STRLCAT (bounded, always terminated)
+   =========================================================== */
+
+/*
+    strlcpy semantics (BSD):
+    ------------------------
+    my_strlcpy(dest, src, size)
+    - size is the FULL size of dest (including room for '\0')
+    - copies at most size - 1 bytes, then ALWAYS writes '\0' (if size > 0)
+    - returns strlen(src)
+    - truncation check for the caller:
+          if (my_strlcpy(buf, src, sizeof(buf)) >= sizeof(buf)) -> truncated
+
+    strlcat semantics (BSD):
+    ------------------------
+    my_strlcat(dest, src, size)
+    - appends src to the string already in dest, never writing past size bytes
+    - returns strlen(initial dest) + strlen(src)  (>= size means truncated)
+    - if dest has no '\0' within size bytes, nothing is written and
+      size + strlen(src) is returned
+
+    Why not "strlen then memcpy"?
+    -----------------------------
+    The usual portable implementation is two passes over src:
+        n = strlen(src); copy = min(n, size-1); memcpy(dest, src, copy);
+    For log lines the string fits in cache either way, but the first pass still
+    costs a full scan. Here src is walked ONCE in windows of 4 vectors (64/128 bytes):
+        - no '\0' in window and room left -> copy the window to dest, continue
+        - '\0' in window                  -> copy the bytes before it, terminate
+        - out of room                     -> copy what fits, terminate, and keep
+                                             scanning (read-only) for strlen(src)
+    The window is tested first and copied right after (it is still in L1), with
+    copy_block's fixed head/tail stores, so varying line lengths cost few branches.
+
+    Page-boundary rule (same idea as section 5):
+    --------------------------------------------
+    An UNALIGNED window load is only used when it stays inside the current page.
+    Near the end of a page we step one byte at a time until the pointer crosses
+    into the next page, so we never touch a page beyond the terminator.
+*/
+
+static const size_t kPageBytes = 4096U;
+
+#if defined(__SSE2__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+// Index of the first '\0' in the kGroupBytes window at p (unaligned), or kGroupBytes.
+// Caller guarantees the window does not cross a page.
+NO_SANITIZE_OVERREAD
+static inline size_t zero_index_window(const char *p)
+{
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i *v = reinterpret_cast<const __m256i *>(p);
+    const uint64_t lo = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(v), zero)))
+                      | (static_cast<uint64_t>(static_cast<uint32_t>(
+                             _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(v + 1), zero)))) << 32);
+    if (lo != 0U) {
+        return static_cast<size_t>(__builtin_ctzll(lo));
+    }
+    const uint64_t hi = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(v + 2), zero)))
+                      | (static_cast<uint64_t>(static_cast<uint32_t>(
+                             _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(v + 3), zero)))) << 32);
+    return (hi != 0U) ? 64U + static_cast<size_t>(__builtin_ctzll(hi)) : kGroupBytes;
+#else
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i *v = reinterpret_cast<const __m128i *>(p);
+    const uint64_t all = static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(v), zero)))
+                       | (static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(v + 1), zero))) << 16)
+                       | (static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(v + 2), zero))) << 32)
+                       | (static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(v + 3), zero))) << 48);
+    return (all != 0U) ? static_cast<size_t>(__builtin_ctzll(all)) : kGroupBytes;
+#endif
+}
+#endif
+
+// Only zero_index_window over-reads (inside one page); it carries
+// NO_SANITIZE_OVERREAD, so the copies into dest stay checked by ASan.
+size_t my_strlcpy(char *dest, const char *src, size_t size)
+{
+    assert(dest != nullptr && src != nullptr);
+
+    if (size == 0U) {
+        return my_strlen_simd(src);
+    }
+
+    const size_t room = size - 1U;   // bytes of src that may be copied
+    size_t copied = 0U;              // also the current offset into src
+
+#if defined(__SSE2__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    for (;;) {
+        const char *p = src + copied;
+        const size_t pageOffset = reinterpret_cast<uintptr_t>(p) & (kPageBytes - 1U);
+
+        if (pageOffset > kPageBytes - kGroupBytes) {
+            // too close to the page end for a full window: one byte at a time
+            if (*p == '\0') {
+                dest[copied] = '\0';
+                return copied;
+            }
+            if (copied == room) {
+                dest[room] = '\0';
+                return room + my_strlen_simd(p);
+            }
+            dest[copied] = *p;
+            ++copied;
+            continue;
+        }
+
+        // one window = 4 vectors (64/128 bytes), loaded once for the '\0' test
+        const size_t zero = zero_index_window(p);   // kGroupBytes if none
+        const size_t left = room - copied;
+
+        if (zero < kGroupBytes || left < kGroupBytes) {
+            // the string or the room for it ends inside this window
+            const size_t n = (zero < left) ? zero : left;
+            copy_block(dest + copied, p, n);
+            dest[copied + n] = '\0';
+            if (zero < kGroupBytes) {
+                return copied + zero;
+            }
+            // truncated and no '\0' yet: keep scanning windows read-only for strlen(src)
+            size_t scanned = copied + kGroupBytes;
+            for (;;) {
+                const char *q = src + scanned;
+                if ((reinterpret_cast<uintptr_t>(q) & (kPageBytes - 1U)) > kPageBytes - kGroupBytes) {
+                    return scanned + my_strlen_simd(q);
+                }
+                const size_t z = zero_index_window(q);
+                if (z < kGroupBytes) {
+                    return scanned + z;
+                }
+                scanned += kGroupBytes;
+            }
+        }
+        copy_block(dest + copied, p, kGroupBytes);
+        copied += kGroupBytes;
+    }
+#else
+    (void)kPageBytes;
+    while (src[copied] != '\0') {
+        if (copied == room) {
+            dest[room] = '\0';
+            return room + my_strlen_prod(src + room);
+        }
+        dest[copied] = src[copied];
+        ++copied;
+    }
+    dest[copied] = '\0';
+    return copied;
+#endif
+}
+
+size_t my_strlcat(char *dest, const char *src, size_t size)
+{
+    assert(dest != nullptr && src != nullptr);
+
+    // bounded: dest might not be terminated within size bytes
+    const size_t destLen = my_strnlen_simd(dest, size);
+    if (destLen == size) {
+        return size + my_strlen_simd(src);
+    }
+    return destLen + my_strlcpy(dest + destLen, src, size - destLen);
+}
+
+/* ===========================================================
+   SMALLSTRING + ARENA (owning strings for many short values)
+   =========================================================== */
+
+/*
+    Problem:
+    --------
+    Everything above works on caller-owned char[] buffers. When a program builds
+    MANY short strings (log fields, "Ace of Spades" card names, boarding passes):
+    - a fixed char[] per string wastes space or risks truncation
+    - one heap allocation per string is slow
+    - my_strlen on the same string again and again repeats the same scan
+
+    SmallString design:
+    -------------------
+    - Small String Optimisation (SSO): up to kInlineCapacity (22) chars are
+      stored INSIDE the object (plus '\0') -> no allocation for short strings.
+    - Length is cached in len_ -> size() is O(1), never rescans for '\0'.
+    - Longer strings go to the heap (new[]) or, if an Arena was given, to the
+      arena. The contents are always '\0'-terminated, so c_str() can be passed
+      to my_strlen_* / my_strcpy / my_strlcpy / cout directly.
+
+    Arena (bump allocator):
+    -----------------------
+    - Hands out memory by bumping an offset inside large blocks.
+    - Individual strings never free their arena memory; reset() releases the
+      whole batch at once (e.g. after one batch of log lines is written out).
+    - RULE: strings using an arena must not be used after arena.reset() or
+      after the arena is destroyed (their storage is gone).
+
+    Copy / move rules:
+    ------------------
+    - Copy: deep copy, uses the SAME arena as the source (nullptr -> heap).
+    - Move: steals heap/arena storage; inline strings are copied (22 bytes).
+    - data_ points either at inline_ or at external storage, so copy/move must
+      re-point it (never copy the raw pointer to another object's inline_).
+*/
+
+class Arena
+{
+public:
+    explicit Arena(size_t blockSize = 64U * 1024U)
+        : blockSize_(blockSize), used_(0U), cap_(0U), firstCap_(0U)
+    {
+    }
+
+    ~Arena()
+    {
+        for (char *block : blocks_) {
+            delete[] block;
+        }
+    }
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    char *allocate(size_t n)
+    {
+        if (blocks_.empty() || used_ + n > cap_) {
+            // oversized requests get a block of their own
+            const size_t size = (n > blockSize_) ? n : blockSize_;
+            blocks_.push_back(new char[size]);
+            used_ = 0U;
+            cap_ = size;
+            if (blocks_.size() == 1U) {
+                firstCap_ = size;
+            }
+        }
+        char *p = blocks_.back() + used_;
+        used_ += n;
+        return p;
+    }
+
+    // Frees everything at once; keeps the first block for the next batch
+    void reset()
+    {
+        for (size_t i = 1U; i < blocks_.size(); ++i) {
+            delete[] blocks_[i];
+        }
+        if (!blocks_.empty()) {
+            blocks_.resize(1U);
+            cap_ = firstCap_;
+        }
+        used_ = 0U;
+    }
+
+    size_t blockCount() const { return blocks_.size(); }
+
+private:
+    size_t blockSize_;
+    size_t used_;                 // bytes used in the current (last) block
+    size_t cap_;                  // size of the current block
+    size_t firstCap_;             // size of blocks_[0] (kept by reset)
+    std::vector<char *> blocks_;
+};
+
+class SmallString
+{
+public:
+    static const size_t kInlineCapacity = 22U;
+
+    explicit SmallString(Arena *arena = nullptr)
+        : len_(0U), cap_(kInlineCapacity), data_(inline_), arena_(arena)
+    {
+        inline_[0] = '\0';
+    }
+
+    SmallString(const char *s, Arena *arena = nullptr)
+        : SmallString(arena)
+    {
+        append(s);
+    }
+
+    SmallString(const char *s, size_t n, Arena *arena = nullptr)
+        : SmallString(arena)
+    {
+        append(s, n);
+    }
+
+    // For buffers that may not be '\0'-terminated (UART, packet fields)
+    static SmallString fromBounded(const char *buf, size_t maxLen, Arena *arena = nullptr)
+    {
+        return SmallString(buf, my_strnlen_simd(buf, maxLen), arena);
+    }
+
+    SmallString(const SmallString &other)
+        : SmallString(other.arena_)
+    {
+        append(other.data_, other.len_);
+    }
+
+    SmallString(SmallString &&other) noexcept
+        : len_(0U), cap_(kInlineCapacity), data_(inline_), arena_(nullptr)
+    {
+        takeFrom(other);
+    }
+
+    SmallString &operator=(const SmallString &other)
+    {
+        if (this != &other) {
+            len_ = 0U;
+            data_[0] = '\0';
+            append(other.data_, other.len_);
+        }
+        return *this;
+    }
+
+    SmallString &operator=(SmallString &&other) noexcept
+    {
+        if (this != &other) {
+            release();
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    ~SmallString()
+    {
+        release();
+    }
+
+    size_t size() const { return len_; }           // cached: no '\0' scan
+    size_t capacity() const { return cap_; }
+    bool isInline() const { return data_ == inline_; }
+    const char *c_str() const { return data_; }
+
+    SmallString &append(const char *s)
+    {
+        assert(s != nullptr);
+        return append(s, my_strlen_simd(s));
+    }
+
+    SmallString &append(const char *s, size_t n)
+    {
+        // s may point into our own buffer (s.append(s), s.append(s.c_str()));
+        // reserve() can free that buffer, so re-base s on the new one
+        const uintptr_t from = reinterpret_cast<uintptr_t>(s);
+        const uintptr_t base = reinterpret_cast<uintptr_t>(data_);
+        if (from >= base && from <= base + cap_) {
+            const size_t offset = static_cast<size_t>(from - base);
+            reserve(len_ + n);
+            s = data_ + offset;
+        } else {
+            reserve(len_ + n);
+        }
+        copy_block(data_ + len_, s, n);
+        len_ += n;
+        data_[len_] = '\0';
+        return *this;
+    }
+
+    SmallString &append(const SmallString &other)
+    {
+        return append(other.data_, other.len_);   // known length, no scan
+    }
+
+    SmallString &append(char c)
+    {
+        reserve(len_ + 1U);
+        data_[len_++] = c;
+        data_[len_] = '\0';
+        return *this;
+    }
+
+    void clear()
+    {
+        len_ = 0U;
+        data_[0] = '\0';
+    }
+
+    // Copies into a caller buffer (always terminated); returns size() like strlcpy
+    size_t copyTo(char *dest, size_t destSize) const
+    {
+        return my_strlcpy(dest, data_, destSize);
+    }
+
+    void reserve(size_t needed)
+    {
+        if (needed <= cap_) {
+            return;
+        }
+        size_t newCap = 2U * cap_;
+        if (newCap < needed) {
+            newCap = needed;
+        }
+        char *fresh = (arena_ != nullptr) ? arena_->allocate(newCap + 1U) : new char[newCap + 1U];
+        copy_block(fresh, data_, len_ + 1U);
+        release();
+        data_ = fresh;
+        cap_ = newCap;
+    }
+
+private:
+    size_t len_;     // cached length (excluding '\0')
+    size_t cap_;     // usable chars (excluding '\0')
+    char *data_;     // inline_ or external storage
+    Arena *arena_;   // nullptr -> heap
+    char inline_[kInlineCapacity + 1U];
+
+    // Move helper: this must be empty (inline) before the call
+    void takeFrom(SmallString &other)
+    {
+        len_ = other.len_;
+        arena_ = other.arena_;
+        if (other.isInline()) {
+            memcpy(inline_, other.inline_, other.len_ + 1U);
+        } else {
+            data_ = other.data_;           // steal heap/arena storage
+            cap_ = other.cap_;
+            other.data_ = other.inline_;
+            other.cap_ = kInlineCapacity;
+        }
+        other.len_ = 0U;
+        other.data_[0] = '\0';
+    }
+
+    void release()
+    {
+        // arena memory is only reclaimed by Arena::reset()
+        if (!isInline() && arena_ == nullptr) {
+            delete[] data_;
+        }
+        data_ = inline_;
+        cap_ = kInlineCapacity;
+    }
+};
+
+/* ===========================================================
+   SUBSTRING SEARCH (memmem / strstr) + MULTI-NEEDLE SEARCH
+   =========================================================== */
+
+/*
+    my_memmem(hay, hayLen, needle, needleLen):
+    ------------------------------------------
+    - Returns a pointer to the FIRST occurrence of needle inside hay, or nullptr.
+    - Works on raw bytes: '\0' is an ordinary byte here (memmem semantics).
+    - needleLen == 0 -> returns hay (empty needle matches at position 0).
+    - Reads only bytes inside [hay, hay + hayLen): safe on mmap'd files.
+
+    my_strstr(hay, needle):
+    -----------------------
+    - C-string wrapper: lengths come from my_strlen_simd, then my_memmem.
+
+    Algorithms (picked by needle length m):
+    ---------------------------------------
+    1) m == 1        -> memchr (libc already vectorises it)
+    2) 2 <= m <= 64  -> "generic SIMD" first/last-byte filter:
+         - compare 16/32 haystack positions at once against needle[0]
+           AND the positions shifted by m-1 against needle[m-1]
+         - AND the two compare masks: only positions where BOTH the first and
+           last bytes match survive (rare for real text)
+         - verify survivors with memcmp of the middle bytes
+    3) m > 64        -> Boyer-Moore-Horspool:
+         - compare the window's last byte first; on mismatch shift by
+           skip[last byte] (up to m positions at once)
+         - long needles -> long shifts -> sub-linear on average
+
+    Aho-Corasick (many needles, one pass):
+    --------------------------------------
+    - Build a trie of all needles, then add "failure" links (longest proper
+      suffix that is also a trie prefix) so the scan never backtracks.
+    - Stored as a full DFA: next[state * 256 + byte] -> one lookup per byte.
+    - Each state keeps the ids of all needles that END there (own + via failure
+      links), so overlapping matches (e.g. "he" inside "she") are all reported.
+*/
+
+static const size_t kShortNeedleMax = 64U;
+
+static const char *memmem_short(const char *hay, size_t hayLen, const char *needle, size_t m)
+{
+    const size_t last = hayLen - m;   // last valid start position
+    size_t i = 0U;
+
+#if defined(__AVX2__)
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i lastByte = _mm256_set1_epi8(needle[m - 1U]);
+    for (; i + 32U <= last + 1U; i += 32U) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(hay + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(hay + i + m - 1U));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, lastByte))));
+        while (mask != 0U) {
+            const size_t pos = i + static_cast<size_t>(__builtin_ctz(mask));
+            if (memcmp(hay + pos + 1U, needle + 1U, m - 2U) == 0) {
+                return hay + pos;
+            }
+            mask &= mask - 1U;   // clear lowest set bit
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i lastByte = _mm_set1_epi8(needle[m - 1U]);
+    for (; i + 16U <= last + 1U; i += 16U) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(hay + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(hay + i + m - 1U));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, lastByte))));
+        while (mask != 0U) {
+            const size_t pos = i + static_cast<size_t>(__builtin_ctz(mask));
+            if (memcmp(hay + pos + 1U, needle + 1U, m - 2U) == 0) {
+                return hay + pos;
+            }
+            mask &= mask - 1U;
+        }
+    }
+#endif
+
+    // scalar tail: same filter, one position at a time
+    for (; i <= last; ++i) {
+        if (hay[i] == needle[0] && hay[i + m - 1U] == needle[m - 1U] &&
+            memcmp(hay + i + 1U, needle + 1U, m - 2U) == 0) {
+            return hay + i;
+        }
+    }
+    return nullptr;
+}
+
+static const char *memmem_horspool(const char *hay, size_t hayLen, const char *needle, size_t m)
+{
+    size_t skip[256];
+    for (size_t c = 0U; c < 256U; ++c) {
+        skip[c] = m;
+    }
+    for (size_t k = 0U; k + 1U < m; ++k) {
+        skip[static_cast<unsigned char>(needle[k])] = m - 1U - k;
+    }
+
+    const unsigned char lastByte = static_cast<unsigned char>(needle[m - 1U]);
+    for (size_t i = 0U; i + m <= hayLen; ) {
+        const unsigned char c = static_cast<unsigned char>(hay[i + m - 1U]);
+        if (c == lastByte && memcmp(hay + i, needle, m - 1U) == 0) {
+            return hay + i;
+        }
+        i += skip[c];
+    }
+    return nullptr;
+}
+
+const char *my_memmem(const char *hay, size_t hayLen, const char *needle, size_t needleLen)
+{
+    assert(hay != nullptr && needle != nullptr);
+
+    if (needleLen == 0U) {
+        return hay;
+    }
+    if (needleLen > hayLen) {
+        return nullptr;
+    }
+    if (needleLen == 1U) {
+        return static_cast<const char *>(memchr(hay, needle[0], hayLen));
+    }
+    if (needleLen <= kShortNeedleMax) {
+        return memmem_short(hay, hayLen, needle, needleLen);
+    }
+    return memmem_horspool(hay, hayLen, needle, needleLen);
+}
+
+const char *my_strstr(const char *hay, const char *needle)
+{
+    assert(hay != nullptr && needle != nullptr);
+
+    return my_memmem(hay, my_strlen_simd(hay), needle, my_strlen_simd(needle));
+}
+
+class AhoCorasick
+{
+public:
+    explicit AhoCorasick(const std::vector<SmallString> &needles)
+        : needleLen_(needles.size())
+    {
+        addState();   // root = state 0
+
+        // 1) trie of all needles (empty needles are ignored)
+        for (size_t id = 0U; id < needles.size(); ++id) {
+            const char *p = needles[id].c_str();
+            const size_t len = needles[id].size();
+            needleLen_[id] = len;
+            if (len == 0U) {
+                continue;
+            }
+            int32_t state = 0;
+            for (size_t k = 0U; k < len; ++k) {
+                const unsigned char c = static_cast<unsigned char>(p[k]);
+                if (next_[state * 256 + c] < 0) {
+                    const int32_t fresh = addState();
+                    next_[state * 256 + c] = fresh;
+                }
+                state = next_[state * 256 + c];
+            }
+            outputs_[state].push_back(static_cast<int32_t>(id));
+        }
+
+        // 2) breadth-first: failure links + complete the DFA transitions
+        std::vector<int32_t> fail(outputs_.size(), 0);
+        std::vector<int32_t> queue;
+        for (int c = 0; c < 256; ++c) {
+            int32_t &t = next_[c];
+            if (t < 0) {
+                t = 0;                 // missing root edge loops back to root
+            } else {
+                fail[t] = 0;
+                queue.push_back(t);
+            }
+        }
+        for (size_t head = 0U; head < queue.size(); ++head) {
+            const int32_t state = queue[head];
+            // inherit matches of the failure state (suffix needles)
+            const std::vector<int32_t> &inherited = outputs_[fail[state]];
+            outputs_[state].insert(outputs_[state].end(), inherited.begin(), inherited.end());
+
+            for (int c = 0; c < 256; ++c) {
+                int32_t &t = next_[state * 256 + c];
+                if (t < 0) {
+                    t = next_[fail[state] * 256 + c];   // DFA shortcut
+                } else {
+                    fail[t] = next_[fail[state] * 256 + c];
+                    queue.push_back(t);
+                }
+            }
+        }
+    }
+
+    /*
+        Calls onMatch(needleId, startOffset) for every occurrence (overlaps
+        included), in order of the match END position. Returns the match count.
+    */
+    size_t scan(const char *text, size_t len,
+                const std::function<void(size_t, size_t)> &onMatch = nullptr) const
+    {
+        size_t matches = 0U;
+        int32_t state = 0;
+        const int32_t *next = next_.data();
+        for (size_t i = 0U; i < len; ++i) {
+            state = next[state * 256 + static_cast<unsigned char>(text[i])];
+            const std::vector<int32_t> &out = outputs_[state];
+            if (!out.empty()) {
+                for (const int32_t id : out) {
+                    ++matches;
+                    if (onMatch) {
+                        onMatch(static_cast<size_t>(id), i + 1U - needleLen_[id]);
+                    }
+                }
+            }
+        }
+        return matches;
+    }
+
+private:
+    std::vector<int32_t> next_;                  // states x 256, full DFA
+    std::vector<std::vector<int32_t>> outputs_;  // needle ids ending at each state
+    std::vector<size_t> needleLen_;
+
+    int32_t addState()
+    {
+        next_.insert(next_.end(), 256U, -1);
+        outputs_.emplace_back();
+        return static_cast<int32_t>(outputs_.size() - 1U);
+    }
+};
+
+/* MappedFile: the --grep input, mapped read-only (mmap on POSIX, read
+   into a vector elsewhere). opened_ records whether that worked; an empty
+   file maps nothing but is still a valid (empty) input. */
+class MappedFile
+{
+public:
+    explicit MappedFile(const char *path)
+        : bytes_(nullptr), size_(0U), mapped_(false), opened_(false)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        const int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == 0) {
+            if (st.st_size == 0) {
+                opened_ = true;
+            } else {
+                void *p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+                    bytes_ = static_cast<const char *>(p);
+                    size_ = static_cast<size_t>(st.st_size);
+                    mapped_ = true;
+                    opened_ = true;
+                }
+            }
+        }
+        close(fd);
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return;
+        }
+        fallback_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        bytes_ = fallback_.data();
+        size_ = fallback_.size();
+        opened_ = true;
+#endif
+    }
+
+    ~MappedFile()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if (mapped_) {
+            munmap(const_cast<char *>(bytes_), size_);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *data() const { return bytes_; }
+    size_t size() const { return size_; }
+    bool ok() const { return opened_; }
+
+private:
+    const char *bytes_;
+    size_t size_;
+    bool mapped_;
+    bool opened_;
+    std::vector<char> fallback_;
+};
+
 /* ===========================================================
    MAIN (TESTS / DEMOS)
    =========================================================== */
@@ -325,8 +1509,369 @@ static void print_bytes(const char *buf, size_t len)
     cout << "]";
 }
 
-int main()
+/* ===========================================================
+   BENCHMARK: strlen family (run with: ./a.out --bench)
+   =========================================================== */
+/*
+    - Lengths from 1 B to 1 MB, each timed over ~64 MB of total scanning so
+      short and long strings get comparable run times.
+    - Results are summed into a volatile sink so the calls can't be removed.
+    - Reported as GB/s (string bytes scanned per second).
+*/
+typedef size_t (*strlen_fn)(const char *);
+
+static size_t glibc_strlen(const char *s)
+{
+    return strlen(s);
+}
+
+static size_t strnlen_simd_1mb(const char *s)
+{
+    return my_strnlen_simd(s, 1U << 20);
+}
+
+static size_t strnlen_prod_1mb(const char *s)
+{
+    return my_strnlen_prod(s, 1U << 20);
+}
+
+static void benchmark_strlen_family()
+{
+    const struct {
+        const char *name;
+        strlen_fn fn;
+    } candidates[] = {
+        { "subscript", my_strlen_subscript },
+        { "pointer", my_strlen_pointer },
+        { "prod", my_strlen_prod },
+        { "strnlen", strnlen_prod_1mb },
+        { "word", my_strlen_word },
+        { "simd", my_strlen_simd },
+        { "strnlen_simd", strnlen_simd_1mb },
+        { "glibc", glibc_strlen },
+    };
+
+    volatile size_t sink = 0U;
+    for (size_t len = 1U; len <= (1U << 20); len *= 4U) {
+        std::vector<char> buf(len + 1U, 'a');
+        buf[len] = '\0';
+        const size_t reps = (64U << 20) / len;
+
+        cout << "len " << len << " B:\n";
+        for (const auto &c : candidates) {
+            const auto t0 = chrono::steady_clock::now();
+            for (size_t r = 0U; r < reps; ++r) {
+                sink = sink + c.fn(buf.data());
+            }
+            const auto t1 = chrono::steady_clock::now();
+            const double secs = chrono::duration<double>(t1 - t0).count();
+            cout << "  " << setw(12) << left << c.name << right << " : " << (static_cast<double>(len) * reps / secs / 1e9) << " GB/s\n";
+        }
+    }
+    (void)sink;
+}
+
+/* ===========================================================
+   BENCHMARK: single-pass my_strlcpy vs "strlen + memcpy"
+   =========================================================== */
+/*
+    Workload: log lines of 20..300 bytes copied into a 128-byte field
+    (like a fixed-size log record), so roughly half the lines truncate.
+    strlcpy_two_pass is the common portable pattern and also serves as the
+    reference implementation for the fuzz harness.
+*/
+static size_t strlcpy_two_pass(char *dest, const char *src, size_t size)
+{
+    const size_t len = strlen(src);
+    if (size != 0U) {
+        const size_t n = (len < size - 1U) ? len : size - 1U;
+        memcpy(dest, src, n);
+        dest[n] = '\0';
+    }
+    return len;
+}
+
+static size_t strlcat_two_pass(char *dest, const char *src, size_t size)
+{
+    const size_t destLen = my_strnlen_prod(dest, size);
+    if (destLen == size) {
+        return size + strlen(src);
+    }
+    return destLen + strlcpy_two_pass(dest + destLen, src, size - destLen);
+}
+
+static void benchmark_bounded_copy()
+{
+    const size_t kLines = 4096U;
+    const size_t kField = 128U;
+    std::mt19937 rng(7U);
+    std::vector<std::vector<char>> lines(kLines);
+    for (auto &line : lines) {
+        const size_t len = 20U + rng() % 281U;
+        line.resize(len + 1U);
+        for (size_t i = 0U; i < len; ++i) {
+            line[i] = static_cast<char>(' ' + rng() % 95U);
+        }
+        line[len] = '\0';
+    }
+
+    typedef size_t (*strlcpy_fn)(char *, const char *, size_t);
+    const struct {
+        const char *name;
+        strlcpy_fn fn;
+    } candidates[] = {
+        { "two-pass", strlcpy_two_pass },
+        { "my_strlcpy", my_strlcpy },
+    };
+
+    char field[kField];
+    volatile size_t sink = 0U;
+    cout << "log lines -> " << kField << "-byte field:\n";
+    for (const auto &c : candidates) {
+        // best of 5 rounds: the two candidates are close, so filter out noise
+        double best = 1e30;
+        for (unsigned round = 0U; round < 5U; ++round) {
+            const auto t0 = chrono::steady_clock::now();
+            for (unsigned rep = 0U; rep < 200U; ++rep) {
+                for (const auto &line : lines) {
+                    sink = sink + c.fn(field, line.data(), kField);
+                }
+            }
+            const auto t1 = chrono::steady_clock::now();
+            const double ns = chrono::duration<double, std::nano>(t1 - t0).count() / (200.0 * kLines);
+            best = (ns < best) ? ns : best;
+        }
+        cout << "  " << setw(12) << left << c.name << right << " : " << best << " ns/line\n";
+    }
+    (void)sink;
+}
+
+/* ===========================================================
+   FUZZ: fast copy paths vs reference (run with: ./a.out --fuzz)
+   =========================================================== */
+/*
+    For random (src alignment, src length, dest alignment, n):
+    - run the reference and the fast version on two destination buffers that
+      start with the same random garbage
+    - the WHOLE buffers must be byte-identical afterwards, which checks
+        * the copied bytes and the '\0'
+        * the exact number of pad bytes
+        * that nothing before dest or after dest + n was touched
+    - strlcpy/strlcat are checked against the two-pass pattern, including the
+      returned length
+    - returns the number of mismatching cases (0 = pass)
+*/
+static int fuzz_copy_paths(unsigned iterations)
 {
+    std::mt19937 rng(20240607U);
+    const size_t kBuf = 4096U;
+    std::vector<char> src(kBuf);
+    std::vector<char> refDest(kBuf + 64U);
+    std::vector<char> fastDest(kBuf + 64U);
+    int failures = 0;
+
+    for (unsigned it = 0U; it < iterations; ++it) {
+        // short strings most of the time, sometimes long ones
+        const size_t srcLen = (rng() % 4U == 0U) ? rng() % 3000U : rng() % 80U;
+        const size_t srcOff = rng() % 64U;
+        const size_t destOff = rng() % 64U;
+        for (size_t i = 0U; i < srcLen; ++i) {
+            src[srcOff + i] = static_cast<char>(1U + rng() % 255U);   // no '\0' inside
+        }
+        src[srcOff + srcLen] = '\0';
+
+        for (size_t i = 0U; i < refDest.size(); ++i) {
+            refDest[i] = fastDest[i] = static_cast<char>(rng());
+        }
+
+        const unsigned which = rng() % 4U;
+        const size_t n = rng() % (srcLen + 100U);
+        size_t refRet = 0U;
+        size_t fastRet = 0U;
+        if (which == 0U) {
+            my_strcpy(refDest.data() + destOff, src.data() + srcOff);
+            my_strcpy_fast(fastDest.data() + destOff, src.data() + srcOff);
+        } else if (which == 1U) {
+            my_strncpy(refDest.data() + destOff, src.data() + srcOff, n);
+            my_strncpy_fast(fastDest.data() + destOff, src.data() + srcOff, n);
+        } else if (which == 2U) {
+            refRet = strlcpy_two_pass(refDest.data() + destOff, src.data() + srcOff, n);
+            fastRet = my_strlcpy(fastDest.data() + destOff, src.data() + srcOff, n);
+        } else {
+            // random existing dest string, sometimes without '\0' inside n
+            const size_t destLen = rng() % 120U;
+            for (size_t i = 0U; i < destLen; ++i) {
+                refDest[destOff + i] = fastDest[destOff + i] = static_cast<char>('a' + i % 26U);
+            }
+            refDest[destOff + destLen] = fastDest[destOff + destLen] = '\0';
+            refRet = strlcat_two_pass(refDest.data() + destOff, src.data() + srcOff, n);
+            fastRet = my_strlcat(fastDest.data() + destOff, src.data() + srcOff, n);
+        }
+        if (refRet != fastRet) {
+            ++failures;
+        }
+
+        if (memcmp(refDest.data(), fastDest.data(), refDest.size()) != 0) {
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+/*
+    memmem fuzz: random haystacks over a tiny alphabet (so matches are common),
+    needles sometimes cut from the haystack, lengths covering all three
+    algorithms. Reference = std::search. Aho-Corasick match counts are checked
+    against counting every needle with repeated my_memmem calls.
+*/
+static int fuzz_substring_search(unsigned iterations)
+{
+    std::mt19937 rng(99U);
+    int failures = 0;
+    std::vector<char> hay;
+
+    for (unsigned it = 0U; it < iterations; ++it) {
+        const size_t hayLen = rng() % 400U;
+        hay.assign(hayLen, 'a');
+        for (char &c : hay) {
+            c = static_cast<char>('a' + rng() % 3U);
+        }
+
+        std::vector<SmallString> needles;
+        for (unsigned k = 0U; k < 1U + rng() % 4U; ++k) {
+            const size_t len = 1U + rng() % ((rng() % 4U == 0U) ? 120U : 6U);
+            SmallString needle;
+            if (hayLen >= len && rng() % 2U == 0U) {
+                needle.append(hay.data() + rng() % (hayLen - len + 1U), len);
+            } else {
+                for (size_t i = 0U; i < len; ++i) {
+                    needle.append(static_cast<char>('a' + rng() % 3U));
+                }
+            }
+            needles.push_back(needle);
+        }
+
+        size_t expectedMatches = 0U;
+        for (const SmallString &needle : needles) {
+            const char *expect = std::search(hay.data(), hay.data() + hayLen,
+                                             needle.c_str(), needle.c_str() + needle.size());
+            if (expect == hay.data() + hayLen) {
+                expect = nullptr;
+            }
+            if (my_memmem(hay.data(), hayLen, needle.c_str(), needle.size()) != expect) {
+                ++failures;
+            }
+            for (const char *p = expect; p != nullptr; ) {
+                ++expectedMatches;
+                const size_t from = static_cast<size_t>(p - hay.data()) + 1U;
+                p = my_memmem(hay.data() + from, hayLen - from, needle.c_str(), needle.size());
+            }
+        }
+
+        AhoCorasick automaton(needles);
+        if (automaton.scan(hay.data(), hayLen) != expectedMatches) {
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+/*
+    SmallString self-append fuzz: append the string to itself (whole, via
+    c_str(), or a suffix of it) while it is inline, on the heap or in an arena,
+    so reserve() moves the buffer the source points into. Reference =
+    std::string. Run under -fsanitize=address to catch reads of freed storage.
+*/
+static int fuzz_small_string_self_append(unsigned iterations)
+{
+    std::mt19937 rng(7U);
+    int failures = 0;
+    Arena arena(256U);
+
+    for (unsigned it = 0U; it < iterations; ++it) {
+        SmallString str((rng() % 3U == 0U) ? &arena : nullptr);
+        std::string ref;
+        const size_t startLen = rng() % 60U;
+        for (size_t i = 0U; i < startLen; ++i) {
+            const char c = static_cast<char>('a' + rng() % 26U);
+            str.append(c);
+            ref.push_back(c);
+        }
+        for (unsigned step = 0U; step < 4U; ++step) {
+            const unsigned how = rng() % 3U;
+            if (how == 0U) {
+                str.append(str);
+                ref += std::string(ref);
+            } else if (how == 1U) {
+                str.append(str.c_str());
+                ref += std::string(ref);
+            } else {
+                const size_t from = (ref.empty()) ? 0U : rng() % (ref.size() + 1U);
+                str.append(str.c_str() + from, str.size() - from);
+                ref += ref.substr(from);
+            }
+            if (str.size() != ref.size() || memcmp(str.c_str(), ref.c_str(), ref.size() + 1U) != 0) {
+                ++failures;
+                break;
+            }
+        }
+        if (rng() % 64U == 0U) {
+            arena.reset();
+        }
+    }
+    return failures;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "--fuzz") == 0) {
+        const int failures = fuzz_copy_paths(200000U);
+        cout << "fuzz copy paths: " << (failures == 0 ? "PASS" : "FAIL")
+             << " (" << failures << " mismatches)\n";
+        const int searchFailures = fuzz_substring_search(20000U);
+        cout << "fuzz substring search: " << (searchFailures == 0 ? "PASS" : "FAIL")
+             << " (" << searchFailures << " mismatches)\n";
+        const int appendFailures = fuzz_small_string_self_append(20000U);
+        cout << "fuzz SmallString self-append: " << (appendFailures == 0 ? "PASS" : "FAIL")
+             << " (" << appendFailures << " mismatches)\n";
+        return (failures == 0 && searchFailures == 0 && appendFailures == 0) ? 0 : 1;
+    }
+    if (argc > 3 && strcmp(argv[1], "--grep") == 0) {
+        // ./a.out --grep FILE TOKEN [TOKEN...]: count occurrences in a mapped file
+        MappedFile file(argv[2]);
+        if (!file.ok()) {
+            cout << "cannot open " << argv[2] << "\n";
+            return 1;
+        }
+        std::vector<SmallString> tokens;
+        for (int a = 3; a < argc; ++a) {
+            tokens.push_back(SmallString(argv[a]));
+        }
+        std::vector<size_t> counts(tokens.size(), 0U);
+        if (tokens.size() == 1U) {
+            const char *p = file.data();
+            const char *end = file.data() + file.size();
+            while (p != nullptr && tokens[0].size() > 0U) {
+                p = my_memmem(p, static_cast<size_t>(end - p), tokens[0].c_str(), tokens[0].size());
+                if (p != nullptr) {
+                    ++counts[0];
+                    ++p;
+                }
+            }
+        } else {
+            AhoCorasick automaton(tokens);
+            automaton.scan(file.data(), file.size(), [&counts](size_t id, size_t) { ++counts[id]; });
+        }
+        for (size_t t = 0U; t < tokens.size(); ++t) {
+            cout << tokens[t].c_str() << ": " << counts[t] << "\n";
+        }
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        benchmark_strlen_family();
+        benchmark_bounded_copy();
+        return 0;
+    }
     const char string1[] = "AAAAAAAAAAAAA";
     const char string2[] = "ZZZZZ";
 
@@ -376,5 +1921,74 @@ int main()
     field2[2] = '\0';
     cout << "As string (manual terminator for demo only): \"" << field2 << "\"\n";
 
+    // Fast strlen family must agree with the byte loops for every alignment/length
+    bool fastAgree = true;
+    char scan[256];
+    for (size_t start = 0U; start < 64U; ++start) {
+        for (size_t len = 0U; start + len < 200U; ++len) {
+            memset(scan, 'x', sizeof(scan));
+            scan[start + len] = '\0';
+            const char *p = scan + start;
+            fastAgree = fastAgree && (my_strlen_word(p) == len) && (my_strlen_simd(p) == len);
+            for (size_t bound = 0U; bound < len + 40U; bound += 7U) {
+                const size_t expect = my_strnlen_prod(p, bound);
+                fastAgree = fastAgree && (my_strnlen_word(p, bound) == expect)
+                                      && (my_strnlen_simd(p, bound) == expect);
+            }
+        }
+    }
+    cout << "\nword/simd strlen agree with byte loops: " << (fastAgree ? "yes" : "no") << "\n";
+
+    // Fast copy paths: same output as the reference demos above
+    char fastName[] = "XXXXXXXXXX";
+    cout << "my_strcpy_fast: " << my_strcpy_fast(fastName, name2) << "\n";
+    char fastField[11] = "XXXXXXXXXX";
+    my_strncpy_fast(fastField, "HI", 8U);
+    cout << "my_strncpy_fast (src=\"HI\", n=8): bytes=";
+    print_bytes(fastField, 10U);
+    cout << "\n";
+
+    // Bounded copy / concatenate: always terminated, return value shows truncation
+    char logField[8];
+    size_t want = my_strlcpy(logField, "BOARDING-PASS", sizeof(logField));
+    cout << "my_strlcpy -> \"" << logField << "\" (needed " << want << ", truncated: "
+         << (want >= sizeof(logField) ? "yes" : "no") << ")\n";
+    char greeting[16] = "HELLO";
+    want = my_strlcat(greeting, ", WORLD", sizeof(greeting));
+    cout << "my_strlcat -> \"" << greeting << "\" (needed " << want << ")\n";
+
+    // SmallString: card names from the same suit/face tables as the card exercises
+    const char *suit[4] = { "Hearts", "Diamonds", "Clubs", "Spades" };
+    const char *face[13] = { "Ace", "Deuce", "Three", "Four", "Five", "Six", "Seven",
+                             "Eight", "Nine", "Ten", "Jack", "Queen", "King" };
+    SmallString card(face[0]);
+    card.append(" of ").append(suit[3]);
+    cout << "SmallString card: \"" << card.c_str() << "\" size=" << card.size()
+         << " inline=" << (card.isInline() ? "yes" : "no") << "\n";
+
+    // Longer strings spill to an arena; one reset() frees the whole batch
+    Arena arena;
+    SmallString pass("BOARDING PASS | ", &arena);
+    pass.append("Seat ").append('1').append('4').append("C | Gate B22 | Group 3");
+    char passField[24];
+    const size_t passLen = pass.copyTo(passField, sizeof(passField));
+    cout << "SmallString pass: size=" << pass.size() << " (my_strlen_simd: " << my_strlen_simd(pass.c_str())
+         << ") inline=" << (pass.isInline() ? "yes" : "no") << ", field=\"" << passField << "\""
+         << (passLen >= sizeof(passField) ? " (truncated)" : "") << "\n";
+    SmallString moved(std::move(pass));
+    cout << "After move: \"" << moved.c_str() << "\", source size=" << pass.size() << "\n";
+
+    // Substring search: single needle and many needles in one pass
+    const char logText[] = "WARN disk 91%; ERROR fan stalled; INFO ok; ERROR disk full";
+    const char *hit = my_strstr(logText, "ERROR");
+    cout << "my_strstr(\"ERROR\") at offset " << (hit != nullptr ? hit - logText : -1) << "\n";
+    std::vector<SmallString> tokens = { SmallString("ERROR"), SmallString("disk"), SmallString("WARN") };
+    AhoCorasick automaton(tokens);
+    cout << "Aho-Corasick matches:";
+    automaton.scan(logText, sizeof(logText) - 1U, [&tokens](size_t id, size_t at) {
+        cout << " " << tokens[id].c_str() << "@" << at;
+    });
+    cout << "\n";
+
     return 0;
 }
@@ -14,11 +14,46 @@
  *       - floating-point form
  *
  * Key C++ Learnings:
- *  - Using int (NOT float) for exact fraction math
+ *  - Using integers (NOT float) for exact fraction math
  *  - Enforcing invariants via a private normalize() function
- *  - Euclid's algorithm for gcd
+ *  - Euclid's algorithm for gcd -> replaced by Stein's binary gcd
+ *    (shifts and subtractions, no modulo per step)
  *  - const member functions for printing (read-only functions)
  *
+ * Overflow (int version overflowed on n*b + d*a for values ~ 50000):
+ *  - numerator/denominator are int64_t
+ *  - every product is formed in __int128 (64 x 64 bits never overflows)
+ *  - the reduced result must fit back into int64_t, otherwise the
+ *    operation is rejected and the object is left unchanged
+ *  - fewer gcds and smaller intermediates by cancelling first
+ *    (n/d is always reduced; see Knuth, TAOCP vol. 2, 4.5.1):
+ *      mul: n/d * a/b = (n/g1 * a/g2) / (d/g2 * b/g1),
+ *           g1 = gcd(n, b), g2 = gcd(a, d)      -> result already reduced
+ *           (a/b is reduced first)
+ *      add: g = gcd(d, b), t = n*(b/g) + a*(d/g)
+ *           t shares no prime with d/g (it would divide n or b/g), so
+ *           only g2 = gcd(t, b) can still cancel:
+ *           result = (t/g2) / ((d/g) * (b/g2))  -> already reduced
+ *           2 small gcds, a/b need not be reduced, and g = b needs no
+ *           gcd at all when b divides d (a running total's denominator)
+ *
+ * No overflow at all (exact money sums, products like (1/3)^50):
+ *  - template<class IntT> class Rational
+ *      Rational<int64_t> (Rational64): the fixed-width class above
+ *      Rational<BigInt>              : arbitrary precision, same interface
+ *  - BigInt keeps values that fit in int64_t inline (no heap) and only
+ *    spills to a vector of 64-bit limbs on overflow
+ *  - gcd is the expensive part for big values, so Rational<BigInt>
+ *    reduces lazily (past a limb threshold, and before printing)
+ *
+ * Many fractions at once (batch kernels, structure of arrays):
+ *  - numerators and denominators in two separate arrays; element-wise
+ *    add / mul / compare take 4 fractions per AVX2 step when the values
+ *    fit in 32 bits, reduce (gcd) only if asked, and split big arrays
+ *    across threads
+ *  - sumBatch keeps a running common denominator (lcm) so most terms
+ *    are one multiply-add, and reduces only occasionally
+ *
  * Design Choice:
  *  - Mutable style (like your Complex exercise):
  *      add/sub/mul/div modify the current object in-place
@@ -27,11 +62,35 @@
 #include <iostream>
 #include <iomanip>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 using std::cout;
 using std::endl;
 
-class Rational {
+typedef __int128 int128;
+typedef unsigned __int128 uint128;
+
+/*
+ * Rational<IntT>:
+ *  - Rational<int64_t> : fixed width, every result reduced at once,
+ *                        overflow rejected (the class right below)
+ *  - Rational<BigInt>  : exact, never overflows, reduced lazily
+ *                        (generic template further down)
+ */
+template<class IntT>
+class Rational;
+
+template<>
+class Rational<int64_t> {
 private:
     /*
      * Internal representation:
@@ -43,45 +102,95 @@ private:
      *  3) fraction is reduced (gcd(|num|,|den|) == 1)
      *  4) if numerator == 0, store as 0/1
      */
-    int numerator;
-    int denominator;
+    int64_t numerator;
+    int64_t denominator;
 
     /*
-     * normalize():
-     *  - Enforces invariants after any state change.
-     *  - Called in constructor + after every arithmetic op.
+     * normalise(num, den):
+     *  - Enforces invariants on raw num/den and stores the result.
+     *  - Called by the constructor.
+     *  - Returns false (object unchanged) if the reduced value does not
+     *    fit in int64_t (only INT64_MIN / -1 does not).
      */
-    void normalise(void);
+    bool normalise(int64_t num, int64_t den);
 
     /*
-     * gcd(a,b):
-     *  - Euclid algorithm
-     *  - returns greatest common divisor
-     *  - inputs expected non-negative
+     * store(negative, magnitude, den):
+     *  - Stores an ALREADY REDUCED result (the arithmetic below cancels
+     *    before multiplying, so no gcd is needed here).
+     *  - Same overflow rule as normalise().
+     */
+    bool store(bool negative, uint128 magnitude, uint128 den);
+
+    /*
+     * operand(a, b, negative, num, den):
+     *  - reduces the incoming a/b to sign + magnitudes (up to 2^63, so
+     *    e.g. 1/INT64_MIN is still a valid operand)
+     *  - rejects b == 0
      */
-    int GCD(int a, int b);
+    static bool operand(int64_t a, int64_t b, bool& negative, uint64_t& num, uint64_t& den);
+
+    /*
+     * quotient(x, y) / remainder(x, y):
+     *  - the gcd is usually 1 (skip the division) and the values usually
+     *    fit in 32 bits (a 32-bit divide is several times cheaper than a
+     *    64-bit one on most x86 cores)
+     */
+    static uint64_t quotient(uint64_t x, uint64_t y) {
+        if (y == 1) return x;
+        if (((x | y) >> 32) == 0) return static_cast<uint32_t>(x) / static_cast<uint32_t>(y);
+        return x / y;
+    }
+    static uint64_t remainder(uint64_t x, uint64_t y) {
+        if (((x | y) >> 32) == 0) return static_cast<uint32_t>(x) % static_cast<uint32_t>(y);
+        return x % y;
+    }
+
+    // this *= (negative ? -1 : 1) * a/b, with a/b reduced, b > 0
+    void multiplyReduced(bool negative, uint64_t a, uint64_t b);
+
+    // this += a/b, with b > 0 (a is 128-bit so -INT64_MIN fits)
+    void addFraction(int128 a, uint64_t b);
+
+    // add/sub entry: rejects b == 0, moves the sign of b into a
+    void addSigned(int128 a, int64_t b);
 
 public:
+    /*
+     * gcd(a,b):
+     *  - Stein's binary algorithm: strip common factors of 2 with one
+     *    ctz, then repeatedly subtract the smaller odd value from the
+     *    larger one and strip its 2s again (no division at all)
+     *  - gcd(0, b) = b; a, b <= 2^63
+     *  - also used by BigInt once its values fit in 64 bits
+     */
+    static uint64_t GCD(uint64_t a, uint64_t b);
+
     /*
      * Constructor:
      *  - initializes raw values
      *  - then normalise() forces the invariants
      */
-    Rational(int num = 1, int den = 1)
-        : numerator(num), denominator(den)
+    Rational(int64_t num = 1, int64_t den = 1)
+        : numerator(0), denominator(1)
     {
-        normalise();
+        normalise(num, den);
     }
 
     /*
      * Mutable arithmetic:
      *  - These modify numerator/denominator directly
-     *  - Then normalise() to restore reduced canonical form
+     *  - The result is reduced on the way (cross-cancellation), so it
+     *    is already in canonical form
+     *  - On overflow they print an error and leave the object unchanged
      */
-    void add(int num, int den);
-    void sub(int num, int den);
-    void mul(int num, int den);
-    void div(int num, int den);
+    void add(int64_t num, int64_t den);
+    void sub(int64_t num, int64_t den);
+    void mul(int64_t num, int64_t den);
+    void div(int64_t num, int64_t den);
+
+    int64_t getNumerator(void) const { return numerator; }
+    int64_t getDenominator(void) const { return denominator; }
 
     /*
      * Printing:
@@ -91,40 +200,65 @@ public:
     void printFloatingPointForm(void) const;
 };
 
-void Rational::add(int a, int b) {
+bool Rational<int64_t>::operand(int64_t a, int64_t b, bool& negative, uint64_t& num, uint64_t& den) {
+    if (b == 0) {
+        cout << "Zero denominator (b == 0) not allowed. Ignoring.\n";
+        return false;
+    }
+    negative = (a < 0) != (b < 0);
+    num = (a < 0) ? 0 - static_cast<uint64_t>(a) : static_cast<uint64_t>(a);
+    den = (b < 0) ? 0 - static_cast<uint64_t>(b) : static_cast<uint64_t>(b);
+    uint64_t divBy = GCD(num, den);
+    num = quotient(num, divBy);
+    den = quotient(den, divBy);
+    return true;
+}
+
+void Rational<int64_t>::add(int64_t a, int64_t b) {
     /*
      * a/b is the incoming rational number.
      * current object is numerator/denominator.
      *
      * Formula:
      *   n/d + a/b = (n*b + d*a) / (d*b)
+     * computed with the cancellation described at the top of the file
      */
-    numerator   = (numerator * b) + (denominator * a);
-    denominator = (denominator * b);
-    normalise();
+    addSigned(a, b);
 }
 
-void Rational::sub(int a, int b) {
+void Rational<int64_t>::sub(int64_t a, int64_t b) {
     /*
      * Formula:
-     *   n/d - a/b = (n*b - d*a) / (d*b)
+     *   n/d - a/b = n/d + (-a)/b
      */
-    numerator   = (numerator * b) - (denominator * a);
-    denominator = (denominator * b);
-    normalise();
+    addSigned(-int128(a), b);
+}
+
+void Rational<int64_t>::addSigned(int128 a, int64_t b) {
+    if (b == 0) {
+        cout << "Zero denominator (b == 0) not allowed. Ignoring.\n";
+        return;
+    }
+    if (b < 0) {
+        addFraction(-a, 0 - static_cast<uint64_t>(b));
+    } else {
+        addFraction(a, static_cast<uint64_t>(b));
+    }
 }
 
-void Rational::mul(int a, int b) {
+void Rational<int64_t>::mul(int64_t a, int64_t b) {
     /*
      * Formula:
      *   n/d * a/b = (n*a) / (d*b)
      */
-    numerator   = numerator * a;
-    denominator = denominator * b;
-    normalise();
+    bool negative;
+    uint64_t num, den;
+    if (operand(a, b, negative, num, den)) {
+        multiplyReduced(negative, num, den);
+    }
 }
 
-void Rational::div(int a, int b) {
+void Rational<int64_t>::div(int64_t a, int64_t b) {
     /*
      * Division:
      *   (n/d) ÷ (a/b) = (n/d) * (b/a)
@@ -137,107 +271,1400 @@ void Rational::div(int a, int b) {
         return;
     }
 
-    numerator   = numerator * b;
-    denominator = denominator * a;
-    normalise();
+    bool negative;
+    uint64_t num, den;
+    if (operand(a, b, negative, num, den)) {
+        // reciprocal of a reduced fraction is reduced
+        multiplyReduced(negative, den, num);
+    }
 }
 
-void Rational::normalise(void) {
+void Rational<int64_t>::multiplyReduced(bool negative, uint64_t a, uint64_t b) {
+    bool thisNegative = numerator < 0;
+    uint64_t n = thisNegative ? 0 - static_cast<uint64_t>(numerator) : static_cast<uint64_t>(numerator);
+    uint64_t d = static_cast<uint64_t>(denominator);
 
-    // Rule 1: denominator must never be 0
-    if (denominator == 0) {
-        cout << "Error: denominator became 0. Forcing denominator to 1.\n";
-        denominator = 1;
+    // cancel across before multiplying: gcd(n, b) and gcd(a, d)
+    uint64_t g1 = GCD(n, b);
+    uint64_t g2 = GCD(a, d);
+    uint128 magnitude = uint128(quotient(n, g1)) * quotient(a, g2);
+    uint128 den = uint128(quotient(d, g2)) * quotient(b, g1);
+    if (!store(thisNegative != negative, magnitude, den)) {
+        cout << "Overflow: product does not fit in 64 bits. Ignoring.\n";
+    }
+}
+
+void Rational<int64_t>::addFraction(int128 a, uint64_t b) {
+    int128 n = numerator;
+    uint64_t d = static_cast<uint64_t>(denominator);
+
+    // b | d is the common case when adding into a running total
+    uint64_t g = (remainder(d, b) == 0) ? b : GCD(d, b);
+    uint64_t bg = quotient(b, g);
+    uint64_t dg = quotient(d, g);
+    int128 t = n * bg + a * dg;
+
+    // only gcd(t, b) = gcd(t mod b, b) can divide the result; 64-bit
+    // arithmetic whenever t fits
+    bool negative = t < 0;
+    uint128 magnitude = negative ? uint128(-t) : uint128(t);
+    bool small = (magnitude >> 64) == 0;
+    uint64_t g2 = GCD(small ? remainder(static_cast<uint64_t>(magnitude), b) : static_cast<uint64_t>(magnitude % b), b);
+    if (g2 != 1) {
+        magnitude = small ? uint128(quotient(static_cast<uint64_t>(magnitude), g2)) : magnitude / g2;
+    }
+    uint128 den = uint128(dg) * quotient(b, g2);
+
+    if (!store(negative, magnitude, den)) {
+        cout << "Overflow: sum does not fit in 64 bits. Ignoring.\n";
     }
+}
 
+bool Rational<int64_t>::store(bool negative, uint128 magnitude, uint128 den) {
     // Rule 4: canonical zero: 0/x -> 0/1
-    if (numerator == 0) {
+    if (magnitude == 0) {
+        numerator = 0;
         denominator = 1;
-        return;
+        return true;
+    }
+    uint128 limit = negative ? (uint128(1) << 63) : (uint128(1) << 63) - 1;
+    if (magnitude > limit || den > (uint128(1) << 63) - 1) {
+        return false;
     }
+    numerator = negative ? static_cast<int64_t>(0 - static_cast<uint64_t>(magnitude)) : static_cast<int64_t>(magnitude);
+    denominator = static_cast<int64_t>(den);
+    return true;
+}
 
-    // Rule 2: denominator must be positive (move sign to numerator)
-    if (denominator < 0) {
-        numerator   = -numerator;
-        denominator = -denominator;
+bool Rational<int64_t>::normalise(int64_t num, int64_t den) {
+
+    // Rule 1: denominator must never be 0
+    if (den == 0) {
+        cout << "Error: denominator became 0. Forcing denominator to 1.\n";
+        den = 1;
     }
 
-    // Rule 3: reduce using gcd
-    int div_by = GCD(std::abs(numerator), std::abs(denominator));
-    numerator   /= div_by;
-    denominator /= div_by;
+    // Rule 2: denominator must be positive (move sign to numerator);
+    // done in 128 bits because -INT64_MIN does not fit in int64_t
+    int128 n = num;
+    int128 d = den;
+    if (d < 0) {
+        n = -n;
+        d = -d;
+    }
+
+    // Rule 3: reduce using gcd (gcd(0, d) = d gives 0/1, Rule 4)
+    bool negative = n < 0;
+    uint64_t magnitude = static_cast<uint64_t>(negative ? -n : n);
+    uint64_t positiveDen = static_cast<uint64_t>(d);
+    uint64_t divBy = GCD(magnitude, positiveDen);
+    if (!store(negative, quotient(magnitude, divBy), quotient(positiveDen, divBy))) {
+        cout << "Overflow: value does not fit in 64 bits. Ignoring.\n";
+        return false;
+    }
+    return true;
 }
 
-int Rational::GCD(int a, int b) {
+uint64_t Rational<int64_t>::GCD(uint64_t a, uint64_t b) {
     /*
-     * Euclid's algorithm:
+     * Stein's algorithm:
      * gcd(a,b):
-     * while b != 0:
-     *   (a,b) = (b, a%b)
-     * return a
+     *   shift = common trailing zeros of a and b
+     *   make b odd
+     *   while a != 0:
+     *     make a odd; (a, b) = (|b - a|, min(a, b))   (odd - odd = even)
+     *   return b << shift
+     * min/abs compile to cmov, so the loop has no data-dependent branch
+     * (the classic "if (a > b) swap" mispredicts about half the time).
+     * Inputs up to 2^63 (every magnitude an int64_t can have): after the
+     * first shifts both are odd and < 2^63, so b - a fits in int64_t.
      */
-    while (b != 0) {
-        int temp = b;
-        b = a % b;
-        a = temp;
-    }
-    return a;
+    if (a == 0) return b;
+    if (b == 0) return a;
+    int aZeros = __builtin_ctzll(a);
+    int bZeros = __builtin_ctzll(b);
+    int shift = (aZeros < bZeros) ? aZeros : bZeros;
+    b >>= bZeros;
+    do {
+        a >>= aZeros;
+        // b - a has the same trailing zeros as |b - a|, so the next shift
+        // is known without waiting for the min/abs; the top bit keeps ctz
+        // defined when a == b (the loop ends then anyway)
+        int64_t diff = static_cast<int64_t>(b - a);
+        aZeros = __builtin_ctzll(static_cast<uint64_t>(diff) | (uint64_t(1) << 63));
+        b = (a < b) ? a : b;
+        a = static_cast<uint64_t>(diff < 0 ? -diff : diff);
+    } while (a != 0);
+    return b << shift;
 }
 
-void Rational::printRationalForm(void) const {
+void Rational<int64_t>::printRationalForm(void) const {
     // Simple fraction display
     cout << "Rational: (" << numerator << "/" << denominator << ")\n";
 }
 
-void Rational::printFloatingPointForm(void) const {
+void Rational<int64_t>::printFloatingPointForm(void) const {
     // Must cast to avoid integer division
     cout << "Float: " << std::fixed
-         << static_cast<double>(numerator) / denominator
+         << static_cast<double>(numerator) / static_cast<double>(denominator)
          << "\n";
 }
 
-int main() {
+typedef Rational<int64_t> Rational64;
+
+/*
+ * BigInt: signed integer of any size, small values stored inline
+ *
+ * Representation:
+ *  - limbs empty  -> the value is `small` (int64_t), no heap at all
+ *  - limbs filled -> the value is (negative ? -1 : 1) * sum limbs[i] * 2^(64 i)
+ *                    (little-endian uint64_t limbs, top limb != 0)
+ *  - a value that fits in int64_t is ALWAYS stored small, so every value
+ *    has exactly one representation (== can compare fields directly)
+ *
+ * Arithmetic:
+ *  - small op small: one instruction + an overflow check
+ *    (__builtin_add/sub/mul_overflow); only an overflow spills to limbs
+ *  - limbs: schoolbook add/sub/mul, Knuth's algorithm D for division
+ *    (TAOCP vol. 2, 4.3.1), 128-bit intermediates per limb
+ *  - / and % truncate toward zero, like the built-in integers
+ */
+class BigInt {
+private:
+    int64_t small;
+    bool negative;                 // sign when spilled
+    std::vector<uint64_t> limbs;   // magnitude when spilled
+
+    typedef std::vector<uint64_t> Magnitude;
+
+    static void trim(Magnitude& m) {
+        while (!m.empty() && m.back() == 0) m.pop_back();
+    }
+
+    Magnitude magnitude(void) const {
+        if (!limbs.empty()) return limbs;
+        Magnitude m;
+        if (small != 0) m.push_back(small < 0 ? 0 - static_cast<uint64_t>(small) : static_cast<uint64_t>(small));
+        return m;
+    }
+
+    bool isNegative(void) const { return limbs.empty() ? small < 0 : negative; }
+
+    // trimmed magnitude + sign -> BigInt, back to small whenever it fits
+    static BigInt fromMagnitude(bool negative, Magnitude m) {
+        trim(m);
+        BigInt r;
+        if (m.empty()) return r;
+        if (m.size() == 1 && (m[0] <= static_cast<uint64_t>(INT64_MAX) || (negative && m[0] == (uint64_t(1) << 63)))) {
+            r.small = negative ? static_cast<int64_t>(0 - m[0]) : static_cast<int64_t>(m[0]);
+            return r;
+        }
+        r.negative = negative;
+        r.limbs = std::move(m);
+        return r;
+    }
+
+    static int compareMagnitude(const Magnitude& a, const Magnitude& b) {
+        if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+        for (size_t i = a.size(); i-- > 0;) {
+            if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    static Magnitude addMagnitude(const Magnitude& a, const Magnitude& b) {
+        const Magnitude& longer = (a.size() >= b.size()) ? a : b;
+        const Magnitude& shorter = (a.size() >= b.size()) ? b : a;
+        Magnitude r(longer.size() + 1);
+        uint64_t carry = 0;
+        for (size_t i = 0; i < longer.size(); ++i) {
+            uint128 sum = uint128(longer[i]) + (i < shorter.size() ? shorter[i] : 0) + carry;
+            r[i] = static_cast<uint64_t>(sum);
+            carry = static_cast<uint64_t>(sum >> 64);
+        }
+        r[longer.size()] = carry;
+        trim(r);
+        return r;
+    }
+
+    // a - b with a >= b
+    static Magnitude subtractMagnitude(const Magnitude& a, const Magnitude& b) {
+        Magnitude r(a.size());
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < a.size(); ++i) {
+            uint64_t y = (i < b.size()) ? b[i] : 0;
+            uint64_t d = a[i] - y - borrow;
+            borrow = (a[i] < y || (a[i] == y && borrow)) ? 1 : 0;
+            r[i] = d;
+        }
+        trim(r);
+        return r;
+    }
+
+    static Magnitude multiplyMagnitude(const Magnitude& a, const Magnitude& b) {
+        if (a.empty() || b.empty()) return Magnitude();
+        Magnitude r(a.size() + b.size(), 0);
+        for (size_t i = 0; i < a.size(); ++i) {
+            uint64_t carry = 0;
+            for (size_t j = 0; j < b.size(); ++j) {
+                uint128 t = uint128(a[i]) * b[j] + r[i + j] + carry;
+                r[i + j] = static_cast<uint64_t>(t);
+                carry = static_cast<uint64_t>(t >> 64);
+            }
+            r[i + b.size()] = carry;
+        }
+        trim(r);
+        return r;
+    }
+
+    // q = a / d, returns a % d (single-limb divisor)
+    static uint64_t divideSmall(const Magnitude& a, uint64_t d, Magnitude& q) {
+        q.assign(a.size(), 0);
+        uint128 rem = 0;
+        for (size_t i = a.size(); i-- > 0;) {
+            uint128 cur = (rem << 64) | a[i];
+            q[i] = static_cast<uint64_t>(cur / d);
+            rem = cur % d;
+        }
+        trim(q);
+        return static_cast<uint64_t>(rem);
+    }
+
+    // m << s for 0 <= s < 64, one extra limb for the bits shifted out
+    static Magnitude shiftLeft(const Magnitude& m, int s) {
+        Magnitude r(m.size() + 1, 0);
+        for (size_t i = 0; i < m.size(); ++i) {
+            r[i] |= m[i] << s;
+            r[i + 1] = (s == 0) ? 0 : m[i] >> (64 - s);
+        }
+        return r;
+    }
+
+    // Knuth D: q = u / v, r = u % v (v has at least 2 limbs, u >= v)
+    static void divideLong(const Magnitude& u, const Magnitude& v, Magnitude& q, Magnitude& r) {
+        size_t n = v.size();
+        size_t m = u.size() - n;
+        int s = __builtin_clzll(v.back());      // normalise: top bit of v set
+        Magnitude vn = shiftLeft(v, s);
+        vn.pop_back();
+        Magnitude un = shiftLeft(u, s);
+        q.assign(m + 1, 0);
+        for (size_t j = m + 1; j-- > 0;) {
+            // estimate from the top two limbs; at most 2 too large
+            uint128 top = (uint128(un[j + n]) << 64) | un[j + n - 1];
+            uint128 qhat = top / vn[n - 1];
+            uint128 rhat = top % vn[n - 1];
+            while ((qhat >> 64) != 0 || qhat * vn[n - 2] > ((rhat << 64) | un[j + n - 2])) {
+                --qhat;
+                rhat += vn[n - 1];
+                if ((rhat >> 64) != 0) break;
+            }
+            // un[j .. j+n] -= qhat * vn
+            int128 borrow = 0;
+            int128 t;
+            for (size_t i = 0; i < n; ++i) {
+                uint128 p = qhat * vn[i];
+                t = int128(un[i + j]) - borrow - int128(static_cast<uint64_t>(p));
+                un[i + j] = static_cast<uint64_t>(t);
+                borrow = int128(p >> 64) - (t >> 64);
+            }
+            t = int128(un[j + n]) - borrow;
+            un[j + n] = static_cast<uint64_t>(t);
+            q[j] = static_cast<uint64_t>(qhat);
+            if (t < 0) {
+                // estimate was one too large: add v back
+                --q[j];
+                uint128 carry = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    carry += uint128(un[i + j]) + vn[i];
+                    un[i + j] = static_cast<uint64_t>(carry);
+                    carry >>= 64;
+                }
+                un[j + n] += static_cast<uint64_t>(carry);
+            }
+        }
+        trim(q);
+        // remainder = un >> s
+        r.assign(n, 0);
+        for (size_t i = 0; i < n; ++i) {
+            r[i] = (s == 0) ? un[i] : (un[i] >> s) | (un[i + 1] << (64 - s));
+        }
+        trim(r);
+    }
+
+    static void divide(const Magnitude& a, const Magnitude& b, Magnitude& q, Magnitude& r) {
+        if (compareMagnitude(a, b) < 0) {
+            q.clear();
+            r = a;
+        } else if (b.size() == 1) {
+            uint64_t rem = divideSmall(a, b[0], q);
+            r.assign(1, rem);
+            trim(r);
+        } else {
+            divideLong(a, b, q, r);
+        }
+    }
+
+public:
+    BigInt(int64_t value = 0) : small(value), negative(false) {}
+
+    bool isSmall(void) const { return limbs.empty(); }
+
+    // 64-bit limbs needed for the magnitude (1 for any small value)
+    size_t limbCount(void) const { return limbs.empty() ? 1 : limbs.size(); }
+
+    int sign(void) const {
+        if (!limbs.empty()) return negative ? -1 : 1;
+        return (small > 0) - (small < 0);
+    }
+
+    BigInt operator-(void) const {
+        if (limbs.empty() && small != INT64_MIN) return BigInt(-small);
+        return fromMagnitude(!isNegative(), magnitude());
+    }
+
+    friend BigInt operator+(const BigInt& x, const BigInt& y) {
+        int64_t r;
+        if (x.limbs.empty() && y.limbs.empty() && !__builtin_add_overflow(x.small, y.small, &r)) return BigInt(r);
+        bool xn = x.isNegative(), yn = y.isNegative();
+        Magnitude a = x.magnitude(), b = y.magnitude();
+        if (xn == yn) return fromMagnitude(xn, addMagnitude(a, b));
+        // opposite signs: larger magnitude minus smaller, sign of the larger
+        if (compareMagnitude(a, b) >= 0) return fromMagnitude(xn, subtractMagnitude(a, b));
+        return fromMagnitude(yn, subtractMagnitude(b, a));
+    }
+
+    friend BigInt operator-(const BigInt& x, const BigInt& y) {
+        int64_t r;
+        if (x.limbs.empty() && y.limbs.empty() && !__builtin_sub_overflow(x.small, y.small, &r)) return BigInt(r);
+        return x + (-y);
+    }
+
+    friend BigInt operator*(const BigInt& x, const BigInt& y) {
+        int64_t r;
+        if (x.limbs.empty() && y.limbs.empty() && !__builtin_mul_overflow(x.small, y.small, &r)) return BigInt(r);
+        return fromMagnitude(x.isNegative() != y.isNegative(), multiplyMagnitude(x.magnitude(), y.magnitude()));
+    }
+
+    // truncating division; y != 0
+    friend BigInt operator/(const BigInt& x, const BigInt& y) {
+        if (x.limbs.empty() && y.limbs.empty() && !(x.small == INT64_MIN && y.small == -1)) return BigInt(x.small / y.small);
+        Magnitude q, r;
+        divide(x.magnitude(), y.magnitude(), q, r);
+        return fromMagnitude(x.isNegative() != y.isNegative(), q);
+    }
+
+    // remainder has the sign of x; y != 0
+    friend BigInt operator%(const BigInt& x, const BigInt& y) {
+        if (x.limbs.empty() && y.limbs.empty()) return BigInt(y.small == -1 ? 0 : x.small % y.small);
+        Magnitude q, r;
+        divide(x.magnitude(), y.magnitude(), q, r);
+        return fromMagnitude(x.isNegative(), r);
+    }
+
+    BigInt& operator+=(const BigInt& y) { return *this = *this + y; }
+    BigInt& operator-=(const BigInt& y) { return *this = *this - y; }
+    BigInt& operator*=(const BigInt& y) { return *this = *this * y; }
+    BigInt& operator/=(const BigInt& y) { return *this = *this / y; }
+
+    friend bool operator==(const BigInt& x, const BigInt& y) {
+        return x.small == y.small && x.negative == y.negative && x.limbs == y.limbs;
+    }
+    friend bool operator!=(const BigInt& x, const BigInt& y) { return !(x == y); }
+
+    friend bool operator<(const BigInt& x, const BigInt& y) {
+        if (x.limbs.empty() && y.limbs.empty()) return x.small < y.small;
+        bool xn = x.isNegative(), yn = y.isNegative();
+        if (xn != yn) return xn;
+        int c = compareMagnitude(x.magnitude(), y.magnitude());
+        return xn ? c > 0 : c < 0;
+    }
+
+    // gcd(|x|, |y|): Euclid on limbs until both fit in 64 bits, then binary
+    friend BigInt gcdOf(BigInt x, BigInt y) {
+        Magnitude a = x.magnitude(), b = y.magnitude();
+        while (a.size() > 1 || b.size() > 1) {
+            if (b.empty()) return fromMagnitude(false, a);
+            Magnitude q, r;
+            divide(a, b, q, r);
+            a.swap(b);
+            b.swap(r);
+        }
+        uint64_t u = a.empty() ? 0 : a[0];
+        uint64_t v = b.empty() ? 0 : b[0];
+        // Rational64::GCD takes values up to 2^63; a full limb may be larger
+        while (v != 0 && (u > (uint64_t(1) << 63) || v > (uint64_t(1) << 63))) {
+            uint64_t rem = u % v;
+            u = v;
+            v = rem;
+        }
+        return fromMagnitude(false, Magnitude(1, Rational64::GCD(u, v)));
+    }
+
+    // x * 2^-exponent as a double with 64 significant bits kept, so that
+    // ratios of huge values do not overflow to inf
+    double scaled(int& exponent) const {
+        if (limbs.empty()) {
+            exponent = 0;
+            return static_cast<double>(small);
+        }
+        size_t n = limbs.size();
+        if (n == 1) {
+            // one spilled limb: a magnitude in (INT64_MAX, 2^64)
+            exponent = 0;
+            double top = static_cast<double>(limbs[0]);
+            return negative ? -top : top;
+        }
+        double top = std::ldexp(static_cast<double>(limbs[n - 1]), 64) + static_cast<double>(limbs[n - 2]);
+        exponent = static_cast<int>(64 * (n - 2));
+        return negative ? -top : top;
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const BigInt& x) {
+        if (x.limbs.empty()) return out << x.small;
+        // peel off 19 decimal digits (10^19 < 2^64) per short division
+        const uint64_t kChunk = 10000000000000000000ULL;
+        std::vector<uint64_t> chunks;
+        Magnitude m = x.limbs, q;
+        while (!m.empty()) {
+            chunks.push_back(divideSmall(m, kChunk, q));
+            m.swap(q);
+        }
+        if (x.negative) out << '-';
+        out << chunks.back();
+        char saved = out.fill('0');
+        for (size_t i = chunks.size() - 1; i-- > 0;) out << std::setw(19) << chunks[i];
+        out.fill(saved);
+        return out;
+    }
+};
+
+inline size_t limbCount(const BigInt& x) { return x.limbCount(); }
+
+inline double ratioToDouble(const BigInt& num, const BigInt& den) {
+    int ne, de;
+    double n = num.scaled(ne);
+    double d = den.scaled(de);
+    return std::ldexp(n / d, ne - de);
+}
+
+/*
+ * Rational<IntT> (generic): exact fractions over an arbitrary-precision IntT
+ *
+ * IntT needs + - * / %, == < , gcdOf(x, y), limbCount(x) and
+ * ratioToDouble(num, den) (provided for BigInt above).
+ *
+ * Lazy normalisation:
+ *  - add/sub/mul/div only keep the cheap invariants (denominator > 0,
+ *    zero stored as 0/1); no gcd per operation
+ *  - the full gcd reduction runs when numerator or denominator grows
+ *    past reduceAt limbs, and before any output / getter
+ *  - after a reduction reduceAt = max(threshold, 2 * current limbs)
+ *    (threshold 0: reduce after every operation), so
+ *    the gcd cost is amortised even when the reduced form itself is big
+ *    (a running total whose denominator keeps growing)
+ *  - same denominator (a/d + b/d, the usual ledger case) adds numerators
+ *    only: no multiplication at all
+ *  - the value never changes, only its representation: numerator and
+ *    denominator are `mutable` so const output can still reduce
+ */
+template<class IntT>
+class Rational {
+private:
+    mutable IntT numerator;
+    mutable IntT denominator;
+    mutable bool reduced;
+    mutable size_t reduceAt;
+    size_t threshold;
+
+    // full gcd reduction (const: same value, smaller representation)
+    void normalise(void) const;
+
+    // cheap invariants after every operation, then reduce if too big
+    void settle(void);
+
+public:
+    Rational(IntT num = 1, IntT den = 1)
+        : numerator(num), denominator(den), reduced(false), reduceAt(4), threshold(4)
+    {
+        settle();
+        normalise();
+    }
+
+    // reduce once numerator or denominator needs more than `limbs` 64-bit
+    // limbs (0: reduce after every operation, like Rational64)
+    void setNormaliseThreshold(size_t limbs) {
+        threshold = limbs;
+        reduceAt = limbs;
+    }
+
+    void add(const IntT& num, const IntT& den);
+    void sub(const IntT& num, const IntT& den);
+    void mul(const IntT& num, const IntT& den);
+    void div(const IntT& num, const IntT& den);
+
+    const IntT& getNumerator(void) const { normalise(); return numerator; }
+    const IntT& getDenominator(void) const { normalise(); return denominator; }
+
+    // current representation size (may be unreduced)
+    size_t storedLimbs(void) const {
+        size_t n = limbCount(numerator), d = limbCount(denominator);
+        return n > d ? n : d;
+    }
+
+    void printRationalForm(void) const;
+    void printFloatingPointForm(void) const;
+};
+
+template<class IntT>
+void Rational<IntT>::settle(void) {
+    // Rule 1: denominator must never be 0
+    if (denominator == IntT(0)) {
+        cout << "Error: denominator became 0. Forcing denominator to 1.\n";
+        denominator = IntT(1);
+    }
+    // Rule 4: canonical zero
+    if (numerator == IntT(0)) {
+        denominator = IntT(1);
+        reduced = true;
+        return;
+    }
+    // Rule 2: sign in the numerator
+    if (denominator < IntT(0)) {
+        numerator = -numerator;
+        denominator = -denominator;
+    }
+    reduced = false;
+    if (storedLimbs() > reduceAt) normalise();
+}
+
+template<class IntT>
+void Rational<IntT>::normalise(void) const {
+    if (reduced) return;
+    // Rule 3: reduce using gcd
+    IntT divBy = gcdOf(numerator, denominator);
+    if (divBy != IntT(1)) {
+        numerator = numerator / divBy;
+        denominator = denominator / divBy;
+    }
+    reduced = true;
+    size_t twice = 2 * storedLimbs();
+    reduceAt = (threshold == 0) ? 0 : (twice > threshold) ? twice : threshold;
+}
+
+template<class IntT>
+void Rational<IntT>::add(const IntT& a, const IntT& b) {
+    if (b == IntT(0)) {
+        cout << "Zero denominator (b == 0) not allowed. Ignoring.\n";
+        return;
+    }
+    if (b == denominator) {
+        numerator = numerator + a;                   // n/d + a/d = (n + a)/d
+    } else {
+        numerator = numerator * b + denominator * a;
+        denominator = denominator * b;
+    }
+    settle();
+}
+
+template<class IntT>
+void Rational<IntT>::sub(const IntT& a, const IntT& b) {
+    add(-a, b);
+}
+
+template<class IntT>
+void Rational<IntT>::mul(const IntT& a, const IntT& b) {
+    if (b == IntT(0)) {
+        cout << "Zero denominator (b == 0) not allowed. Ignoring.\n";
+        return;
+    }
+    numerator = numerator * a;
+    denominator = denominator * b;
+    settle();
+}
+
+template<class IntT>
+void Rational<IntT>::div(const IntT& a, const IntT& b) {
+    if (a == IntT(0)) {
+        cout << "Division by zero fraction not allowed (a == 0). Ignoring.\n";
+        return;
+    }
+    if (b == IntT(0)) {
+        cout << "Zero denominator (b == 0) not allowed. Ignoring.\n";
+        return;
+    }
+    numerator = numerator * b;
+    denominator = denominator * a;
+    settle();
+}
+
+template<class IntT>
+void Rational<IntT>::printRationalForm(void) const {
+    normalise();
+    cout << "Rational: (" << numerator << "/" << denominator << ")\n";
+}
+
+template<class IntT>
+void Rational<IntT>::printFloatingPointForm(void) const {
+    normalise();
+    cout << "Float: " << std::fixed << ratioToDouble(numerator, denominator) << "\n";
+}
+
+/*
+ * Batch kernels: many fractions at once, kept as two arrays
+ * (structure of arrays) instead of an array of Rational objects
+ *
+ *   fraction i = num[i] / den[i], den[i] > 0   (Rational64's canonical sign)
+ *
+ *  - addBatch / mulBatch: out[i] = a[i] + b[i] / a[i] * b[i]
+ *                         (outNum/outDen may be the a or b arrays)
+ *  - compareBatch       : out[i] = -1, 0, 1 for a[i] <, ==, > b[i]
+ *  - normaliseBatch     : reduce in place (after reduce = false chains)
+ *  - sumBatch           : exact sum of all fractions (Rational<BigInt>)
+ *
+ * Why separate arrays:
+ *  - 4 numerators sit next to each other, so one AVX2 load fills 4 lanes
+ *    and there is no per-object call
+ *  - AVX2 has no 64 x 64-bit multiply, but _mm256_mul_epi32 gives exact
+ *    32 x 32 -> 64-bit products: a block of 4 whose values all fit in
+ *    int32 (denominators in 1..INT32_MAX) takes that path, where
+ *    n*b + a*d and d*b cannot overflow int64_t; any other block goes
+ *    through the scalar 128-bit path element by element
+ *  - reduce = true : every result is reduced (one binary gcd per
+ *                    element, scalar: its loop length depends on the data)
+ *    reduce = false: raw results n*b + a*d over d*b (n*a over d*b for mul),
+ *                    the same on the scalar and AVX2 paths; zero is still
+ *                    stored as 0/1, and a raw value that would not fit
+ *                    int64_t is reduced instead
+ *  - an element whose result does not fit int64_t (or has a denominator
+ *    <= 0) is stored as 0/0; the kernels return how many were
+ *  - threads (0 = one per core): chunks of at least 64K fractions
+ */
+const size_t kBatchMinChunk = size_t(1) << 16;
+
+// body(begin, end) returns a count; the counts of all chunks are summed
+template<class Body>
+size_t batchParallel(size_t count, unsigned threads, Body body) {
+    if (threads == 0) threads = std::max(1U, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, count / kBatchMinChunk)));
+    if (threads == 1) return body(size_t(0), count);
+    std::vector<size_t> counts(threads, 0);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        size_t begin = count * t / threads;
+        size_t end = count * (t + 1) / threads;
+        workers.emplace_back([&counts, &body, t, begin, end]() { counts[t] = body(begin, end); });
+    }
+    for (std::thread& w : workers) w.join();
+    size_t total = 0;
+    for (size_t c : counts) total += c;
+    return total;
+}
+
+// Euclid steps until both values fit Rational64::GCD (<= 2^63)
+uint128 gcd128(uint128 a, uint128 b) {
+    const uint128 kLimit = uint128(1) << 63;
+    while (a > kLimit || b > kLimit) {
+        if (b == 0) return a;
+        uint128 r = a % b;
+        a = b;
+        b = r;
+    }
+    return Rational64::GCD(static_cast<uint64_t>(a), static_cast<uint64_t>(b));
+}
+
+// an element with no valid result: 0/0
+bool rejectBatchResult(int64_t& outNum, int64_t& outDen) {
+    outNum = 0;
+    outDen = 0;
+    return false;
+}
+
+// stores num/den (den > 0) as int64_t, reduced if asked or if it does not
+// fit otherwise; false (stored as 0/0) if even the reduced value does not fit
+bool storeBatchResult(int128 num, int128 den, bool reduce, int64_t& outNum, int64_t& outDen) {
+    if (num == 0) {
+        outNum = 0;
+        outDen = 1;
+        return true;
+    }
+    bool negative = num < 0;
+    uint128 magnitude = negative ? 0 - static_cast<uint128>(num) : static_cast<uint128>(num);
+    uint128 d = static_cast<uint128>(den);
+    uint128 limit = negative ? (uint128(1) << 63) : static_cast<uint128>(INT64_MAX);
+    if (reduce || magnitude > limit || d > static_cast<uint128>(INT64_MAX)) {
+        uint128 divBy = gcd128(magnitude, d);
+        magnitude /= divBy;
+        d /= divBy;
+    }
+    if (magnitude > limit || d > static_cast<uint128>(INT64_MAX)) return rejectBatchResult(outNum, outDen);
+    uint64_t m = static_cast<uint64_t>(magnitude);
+    outNum = negative ? static_cast<int64_t>(0 - m) : static_cast<int64_t>(m);
+    outDen = static_cast<int64_t>(d);
+    return true;
+}
+
+// one element of each kernel, 128-bit products (never overflow)
+bool addOne(int64_t an, int64_t ad, int64_t bn, int64_t bd, bool reduce, int64_t& outNum, int64_t& outDen) {
+    if (ad <= 0 || bd <= 0) return rejectBatchResult(outNum, outDen);
+    // same-denominator shortcut only when reducing: raw results must be
+    // n*b + a*d over d*b, exactly what the AVX2 lanes produce
+    if (reduce && ad == bd) return storeBatchResult(int128(an) + bn, ad, reduce, outNum, outDen);
+    return storeBatchResult(int128(an) * bd + int128(bn) * ad, int128(ad) * bd, reduce, outNum, outDen);
+}
+
+bool mulOne(int64_t an, int64_t ad, int64_t bn, int64_t bd, bool reduce, int64_t& outNum, int64_t& outDen) {
+    if (ad <= 0 || bd <= 0) return rejectBatchResult(outNum, outDen);
+    return storeBatchResult(int128(an) * bn, int128(ad) * bd, reduce, outNum, outDen);
+}
+
+bool compareOne(int64_t an, int64_t ad, int64_t bn, int64_t bd, int8_t& out) {
+    if (ad <= 0 || bd <= 0) {
+        out = 0;
+        return false;
+    }
+    int128 left = int128(an) * bd, right = int128(bn) * ad;
+    out = static_cast<int8_t>((left > right) - (left < right));
+    return true;
+}
+
+// |num| < 2^63, den > 0: reduce in place (num == 0 gives 0/1)
+inline void reduceInPlace(int64_t& num, int64_t& den) {
+    uint64_t magnitude = (num < 0) ? 0 - static_cast<uint64_t>(num) : static_cast<uint64_t>(num);
+    uint64_t divBy = Rational64::GCD(magnitude, static_cast<uint64_t>(den));
+    if (divBy != 1) {
+        num /= static_cast<int64_t>(divBy);
+        den /= static_cast<int64_t>(divBy);
+    }
+}
+
+#if defined(__AVX2__)
+// numerators in int32 range and denominators in 1..INT32_MAX, all 4 lanes
+inline bool fitsInt32(__m256i num, __m256i den) {
+    const __m256i kMax = _mm256_set1_epi64x(INT32_MAX);
+    const __m256i kMin = _mm256_set1_epi64x(INT32_MIN);
+    const __m256i kOne = _mm256_set1_epi64x(1);
+    __m256i bad = _mm256_or_si256(_mm256_cmpgt_epi64(num, kMax), _mm256_cmpgt_epi64(kMin, num));
+    bad = _mm256_or_si256(bad, _mm256_or_si256(_mm256_cmpgt_epi64(den, kMax), _mm256_cmpgt_epi64(kOne, den)));
+    return _mm256_testz_si256(bad, bad) != 0;
+}
+
+inline __m256i loadLanes(const int64_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+// stores 4 raw results (zero as 0/1), then reduces them if asked
+inline void storeLanes(__m256i num, __m256i den, bool reduce, int64_t* outNum, int64_t* outDen) {
+    __m256i zero = _mm256_cmpeq_epi64(num, _mm256_setzero_si256());
+    den = _mm256_blendv_epi8(den, _mm256_set1_epi64x(1), zero);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(outNum), num);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(outDen), den);
+    if (reduce) {
+        for (int k = 0; k < 4; ++k) reduceInPlace(outNum[k], outDen[k]);
+    }
+}
+#endif
 
-    auto show = [](const char* label, const Rational& r) {
+size_t addChunk(const int64_t* an, const int64_t* ad, const int64_t* bn, const int64_t* bd,
+                int64_t* outNum, int64_t* outDen, size_t begin, size_t end, bool reduce) {
+    size_t rejected = 0;
+    size_t i = begin;
+#if defined(__AVX2__)
+    for (; i + 4 <= end; i += 4) {
+        __m256i a = loadLanes(an + i), aDen = loadLanes(ad + i);
+        __m256i b = loadLanes(bn + i), bDen = loadLanes(bd + i);
+        if (!fitsInt32(a, aDen) || !fitsInt32(b, bDen)) {
+            for (size_t k = i; k < i + 4; ++k) rejected += !addOne(an[k], ad[k], bn[k], bd[k], reduce, outNum[k], outDen[k]);
+            continue;
+        }
+        __m256i num = _mm256_add_epi64(_mm256_mul_epi32(a, bDen), _mm256_mul_epi32(b, aDen));
+        storeLanes(num, _mm256_mul_epi32(aDen, bDen), reduce, outNum + i, outDen + i);
+    }
+#endif
+    for (; i < end; ++i) rejected += !addOne(an[i], ad[i], bn[i], bd[i], reduce, outNum[i], outDen[i]);
+    return rejected;
+}
+
+size_t mulChunk(const int64_t* an, const int64_t* ad, const int64_t* bn, const int64_t* bd,
+                int64_t* outNum, int64_t* outDen, size_t begin, size_t end, bool reduce) {
+    size_t rejected = 0;
+    size_t i = begin;
+#if defined(__AVX2__)
+    for (; i + 4 <= end; i += 4) {
+        __m256i a = loadLanes(an + i), aDen = loadLanes(ad + i);
+        __m256i b = loadLanes(bn + i), bDen = loadLanes(bd + i);
+        if (!fitsInt32(a, aDen) || !fitsInt32(b, bDen)) {
+            for (size_t k = i; k < i + 4; ++k) rejected += !mulOne(an[k], ad[k], bn[k], bd[k], reduce, outNum[k], outDen[k]);
+            continue;
+        }
+        storeLanes(_mm256_mul_epi32(a, b), _mm256_mul_epi32(aDen, bDen), reduce, outNum + i, outDen + i);
+    }
+#endif
+    for (; i < end; ++i) rejected += !mulOne(an[i], ad[i], bn[i], bd[i], reduce, outNum[i], outDen[i]);
+    return rejected;
+}
+
+size_t compareChunk(const int64_t* an, const int64_t* ad, const int64_t* bn, const int64_t* bd,
+                    int8_t* out, size_t begin, size_t end) {
+    size_t rejected = 0;
+    size_t i = begin;
+#if defined(__AVX2__)
+    for (; i + 4 <= end; i += 4) {
+        __m256i a = loadLanes(an + i), aDen = loadLanes(ad + i);
+        __m256i b = loadLanes(bn + i), bDen = loadLanes(bd + i);
+        if (!fitsInt32(a, aDen) || !fitsInt32(b, bDen)) {
+            for (size_t k = i; k < i + 4; ++k) rejected += !compareOne(an[k], ad[k], bn[k], bd[k], out[k]);
+            continue;
+        }
+        // a/ad vs b/bd  <=>  a*bd vs b*ad (denominators > 0)
+        __m256i left = _mm256_mul_epi32(a, bDen), right = _mm256_mul_epi32(b, aDen);
+        int greater = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(left, right)));
+        int less = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(right, left)));
+        for (int k = 0; k < 4; ++k) out[i + k] = static_cast<int8_t>(((greater >> k) & 1) - ((less >> k) & 1));
+    }
+#endif
+    for (; i < end; ++i) rejected += !compareOne(an[i], ad[i], bn[i], bd[i], out[i]);
+    return rejected;
+}
+
+size_t addBatch(const int64_t* an, const int64_t* ad, const int64_t* bn, const int64_t* bd,
+                int64_t* outNum, int64_t* outDen, size_t count, bool reduce = true, unsigned threads = 0) {
+    return batchParallel(count, threads, [=](size_t begin, size_t end) {
+        return addChunk(an, ad, bn, bd, outNum, outDen, begin, end, reduce);
+    });
+}
+
+size_t mulBatch(const int64_t* an, const int64_t* ad, const int64_t* bn, const int64_t* bd,
+                int64_t* outNum, int64_t* outDen, size_t count, bool reduce = true, unsigned threads = 0) {
+    return batchParallel(count, threads, [=](size_t begin, size_t end) {
+        return mulChunk(an, ad, bn, bd, outNum, outDen, begin, end, reduce);
+    });
+}
+
+size_t compareBatch(const int64_t* an, const int64_t* ad, const int64_t* bn, const int64_t* bd,
+                    int8_t* out, size_t count, unsigned threads = 0) {
+    return batchParallel(count, threads, [=](size_t begin, size_t end) {
+        return compareChunk(an, ad, bn, bd, out, begin, end);
+    });
+}
+
+// any sign of the denominator accepted here; den == 0 is rejected (0/0)
+size_t normaliseBatch(int64_t* num, int64_t* den, size_t count, unsigned threads = 0) {
+    return batchParallel(count, threads, [=](size_t begin, size_t end) {
+        size_t rejected = 0;
+        for (size_t i = begin; i < end; ++i) {
+            int128 n = num[i], d = den[i];
+            if (d < 0) {
+                n = -n;
+                d = -d;
+            }
+            rejected += (d == 0) ? !rejectBatchResult(num[i], den[i]) : !storeBatchResult(n, d, true, num[i], den[i]);
+        }
+        return rejected;
+    });
+}
+
+// int128 -> BigInt (BigInt is built from int64_t pieces)
+BigInt bigFrom128(int128 value) {
+    const BigInt kHalf(int64_t(1) << 32);
+    uint64_t low = static_cast<uint64_t>(value);
+    BigInt high(static_cast<int64_t>(value >> 64));   // arithmetic shift: floor
+    return (high * kHalf + BigInt(static_cast<int64_t>(low >> 32))) * kHalf +
+           BigInt(static_cast<int64_t>(low & 0xFFFFFFFFULL));
+}
+
+/*
+ * RunningSum (one per thread in sumBatch):
+ *  - sum = numerator / denominator, denominator = lcm of the
+ *    denominators seen so far, numerator 128-bit
+ *  - a term n/d with d | denominator adds n * (denominator / d): one
+ *    multiply-add, no gcd; denominator / d is cached per d (small
+ *    direct-mapped table, cleared when the denominator changes), so a
+ *    few distinct denominators cost no division per term either
+ *  - a new d grows the denominator to lcm (one gcd) and rescales the
+ *    numerator
+ *  - reduced only occasionally: when |numerator| passes 2^125
+ *  - when a value would still not fit, the partial sum moves into
+ *    `spilled` (Rational<BigInt>) and the running sum starts over,
+ *    so the result is exact for any input
+ */
+class RunningSum {
+private:
+    static const int kCacheBits = 8;
+    int128 numerator;
+    uint64_t denominator;
+    Rational<BigInt> spilled;
+    uint64_t cacheKey[1 << kCacheBits];
+    uint64_t cacheFactor[1 << kCacheBits];
+
+    void clearCache(void) { std::memset(cacheKey, 0, sizeof(cacheKey)); }
+
+    void spill(void) {
+        if (numerator != 0) spilled.add(bigFrom128(numerator), BigInt(static_cast<int64_t>(denominator)));
+        numerator = 0;
+    }
+
+    void setDenominator(uint64_t den) {
+        denominator = den;
+        clearCache();
+    }
+
+    // the occasional reduction; spills if the numerator is still too big
+    void shrink(void);
+
+    // denominator := lcm(denominator, d)
+    void grow(uint64_t d);
+
+public:
+    RunningSum() : numerator(0), denominator(1), spilled(0, 1) { clearCache(); }
+
+    // false: d <= 0, term ignored
+    bool add(int64_t n, int64_t d);
+
+    Rational<BigInt> result(void) {
+        spill();
+        return spilled;
+    }
+};
+
+const int128 kRunningLimit = int128(1) << 125;
+
+void RunningSum::shrink(void) {
+    uint128 magnitude = (numerator < 0) ? 0 - static_cast<uint128>(numerator) : static_cast<uint128>(numerator);
+    uint64_t divBy = static_cast<uint64_t>(gcd128(magnitude, denominator));
+    if (divBy != 1) {
+        numerator /= static_cast<int128>(divBy);
+        setDenominator(denominator / divBy);
+    }
+    if (numerator > kRunningLimit || numerator < -kRunningLimit) spill();
+}
+
+void RunningSum::grow(uint64_t d) {
+    uint64_t scale = d / Rational64::GCD(denominator, d);
+    uint128 lcm = uint128(denominator) * scale;
+    if (lcm > static_cast<uint128>(INT64_MAX)) {
+        spill();                                   // start over at /d
+        setDenominator(d);
+        return;
+    }
+    // |numerator| <= 2^125 here; keep it there after scaling
+    if (numerator > kRunningLimit / static_cast<int128>(scale) || numerator < -kRunningLimit / static_cast<int128>(scale)) {
+        spill();
+    }
+    numerator *= static_cast<int128>(scale);
+    setDenominator(static_cast<uint64_t>(lcm));
+}
+
+bool RunningSum::add(int64_t n, int64_t d) {
+    if (d <= 0) return false;
+    // |numerator| <= 2^125 and |n * factor| <= 2^126: the sum stays below 2^127
+    if (numerator > kRunningLimit || numerator < -kRunningLimit) shrink();
+    uint64_t ud = static_cast<uint64_t>(d);
+    size_t slot = static_cast<size_t>((ud * 0x9E3779B97F4A7C15ULL) >> (64 - kCacheBits));
+    uint64_t factor;
+    if (cacheKey[slot] == ud) {
+        factor = cacheFactor[slot];
+    } else {
+        if (denominator % ud != 0) grow(ud);
+        factor = denominator / ud;
+        cacheKey[slot] = ud;
+        cacheFactor[slot] = factor;
+    }
+    numerator += int128(n) * static_cast<int128>(factor);
+    return true;
+}
+
+/*
+ * sumBatch: each thread sums its own chunk with a RunningSum, the
+ * partial sums are added at the end (usually with equal denominators)
+ */
+Rational<BigInt> sumBatch(const int64_t* num, const int64_t* den, size_t count, unsigned threads = 0) {
+    if (threads == 0) threads = std::max(1U, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, count / kBatchMinChunk)));
+    std::vector<Rational<BigInt>> partial(threads, Rational<BigInt>(0, 1));
+    std::vector<size_t> rejectedBy(threads, 0);
+    auto sumChunk = [&](unsigned t) {
+        RunningSum running;
+        size_t end = count * (t + 1) / threads;
+        for (size_t i = count * t / threads; i < end; ++i) rejectedBy[t] += !running.add(num[i], den[i]);
+        partial[t] = running.result();
+    };
+    if (threads == 1) {
+        sumChunk(0);
+    } else {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; t++) workers.emplace_back(sumChunk, t);
+        for (std::thread& w : workers) w.join();
+    }
+    size_t rejected = 0;
+    for (size_t r : rejectedBy) rejected += r;
+    if (rejected != 0) {
+        cout << "sumBatch: " << rejected << " terms with denominator <= 0. Ignoring.\n";
+    }
+    Rational<BigInt> total = partial[0];
+    for (unsigned t = 1; t < threads; t++) total.add(partial[t].getNumerator(), partial[t].getDenominator());
+    return total;
+}
+
+/*
+ * Bulk benchmark (./a.out --bench [N], default N = 10^8):
+ *  sums N pseudo-random fractions a/b (|a| <= 1000, b a divisor of
+ *  720720 = lcm(1..16), like amounts in mixed units) three ways:
+ *   - Rational64::add: binary gcd + cross-cancellation
+ *   - textbook       : (n*b + d*a) / (d*b), then Euclid's gcd (modulo per step)
+ *   - exact check    : every term scaled to /720720 and summed as one integer
+ */
+int benchmarkRational(long long count) {
+    const uint64_t kCommon = 720720;
+    uint64_t divisors[256];
+    int divisorCount = 0;
+    for (uint64_t b = 1; b <= kCommon; ++b) {
+        if (kCommon % b == 0) divisors[divisorCount++] = b;
+    }
+
+    // xorshift64: the same term stream for all three passes
+    auto nextTerm = [&](uint64_t& state, int64_t& a, int64_t& b) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        a = static_cast<int64_t>(state % 2001) - 1000;
+        b = static_cast<int64_t>(divisors[(state >> 32) % static_cast<uint64_t>(divisorCount)]);
+    };
+
+    uint64_t state = 48;
+    Rational64 sum(0, 1);
+    auto t0 = std::chrono::steady_clock::now();
+    for (long long i = 0; i < count; ++i) {
+        int64_t a, b;
+        nextTerm(state, a, b);
+        sum.add(a, b);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    state = 48;
+    int64_t n = 0, d = 1;
+    for (long long i = 0; i < count; ++i) {
+        int64_t a, b;
+        nextTerm(state, a, b);
+        int128 num = int128(n) * b + int128(d) * a;
+        int128 den = int128(d) * b;
+        uint64_t x = static_cast<uint64_t>(num < 0 ? -num : num);   // fits: den | 720720^2
+        uint64_t y = static_cast<uint64_t>(den);
+        while (y != 0) {
+            uint64_t temp = y;
+            y = x % y;
+            x = temp;
+        }
+        n = static_cast<int64_t>(num / static_cast<int128>(x));
+        d = static_cast<int64_t>(den / static_cast<int128>(x));
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    state = 48;
+    int128 total = 0;
+    for (long long i = 0; i < count; ++i) {
+        int64_t a, b;
+        nextTerm(state, a, b);
+        total += int128(a) * static_cast<int64_t>(kCommon / static_cast<uint64_t>(b));
+    }
+    Rational64 exact(static_cast<int64_t>(total), static_cast<int64_t>(kCommon));
+
+    bool same = sum.getNumerator() == exact.getNumerator() && sum.getDenominator() == exact.getDenominator() &&
+                n == exact.getNumerator() && d == exact.getDenominator();
+    double fast = std::chrono::duration<double>(t1 - t0).count();
+    double textbook = std::chrono::duration<double>(t2 - t1).count();
+    cout << "sum of " << count << " fractions = " << sum.getNumerator() << "/" << sum.getDenominator() << "\n";
+    cout << "  Rational64::add " << fast << " s (" << fast * 1e9 / static_cast<double>(count) << " ns/add)\n";
+    cout << "  textbook      " << textbook << " s (" << textbook * 1e9 / static_cast<double>(count) << " ns/add)\n";
+    cout << "  results match: " << (same ? "yes" : "NO") << "\n";
+    return same ? 0 : 1;
+}
+
+/*
+ * BigInt benchmark (part of --bench):
+ *  - ledger  : 10^7 amounts in cents (a/100) into Rational<BigInt> vs
+ *              Rational64: values stay small, so BigInt never leaves
+ *              its inline int64_t and same-denominator adds skip the
+ *              multiplications
+ *  - harmonic: exact 1 + 1/2 + ... + 1/n (the denominator grows to
+ *              thousands of bits) reduced after every add vs lazily
+ */
+int benchmarkBigRational(void) {
+    const int kAmounts = 10000000;
+    uint64_t state = 49;
+    Rational<BigInt> ledger(0, 100);
+    Rational64 ledger64(0, 100);
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kAmounts; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        ledger.add(static_cast<int64_t>(state % 200001) - 100000, 100);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    state = 49;
+    for (int i = 0; i < kAmounts; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        ledger64.add(static_cast<int64_t>(state % 200001) - 100000, 100);
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    bool same = ledger.getNumerator() == BigInt(ledger64.getNumerator()) &&
+                ledger.getDenominator() == BigInt(ledger64.getDenominator());
+
+    const int kTerms = 2000;
+    Rational<BigInt> eager(0, 1), lazy(0, 1);
+    eager.setNormaliseThreshold(0);
+    size_t peakLimbs = 0;
+    auto t3 = std::chrono::steady_clock::now();
+    for (int k = 1; k <= kTerms; ++k) eager.add(1, k);
+    auto t4 = std::chrono::steady_clock::now();
+    for (int k = 1; k <= kTerms; ++k) {
+        lazy.add(1, k);
+        if (lazy.storedLimbs() > peakLimbs) peakLimbs = lazy.storedLimbs();
+    }
+    lazy.getNumerator();   // final reduction counts too
+    auto t5 = std::chrono::steady_clock::now();
+    same = same && eager.getNumerator() == lazy.getNumerator() && eager.getDenominator() == lazy.getDenominator();
+
+    auto ms = [](std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    };
+    cout << "ledger of " << kAmounts << " cent amounts: Rational<BigInt> " << ms(t0, t1)
+         << " ms, Rational64 " << ms(t1, t2) << " ms\n";
+    cout << "harmonic H(" << kTerms << "), denominator " << lazy.getDenominator().limbCount()
+         << " limbs: eager " << ms(t3, t4) << " ms, lazy " << ms(t4, t5) << " ms (peak "
+         << peakLimbs << " limbs)\n";
+    cout << "  results match: " << (same ? "yes" : "NO") << "\n";
+    return same ? 0 : 1;
+}
+
+/*
+ * Batch benchmark (part of --bench), 2^22 fraction pairs
+ * (|num| <= 10^6, den in 1..10^6, reduced):
+ *  - add / mul : Rational64 objects one by one vs addBatch/mulBatch
+ *                (reduced, raw, and on all cores)
+ *  - compare   : 128-bit cross products per object vs compareBatch
+ *  - sum       : the 720720-divisor stream of benchmarkRational summed
+ *                by Rational64::add vs sumBatch
+ */
+int benchmarkBatch(void) {
+    const size_t kPairs = size_t(1) << 22;
+    uint64_t state = 50;
+    auto next = [&state]() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+    std::vector<Rational64> left, right;
+    left.reserve(kPairs);
+    right.reserve(kPairs);
+    for (size_t i = 0; i < kPairs; ++i) {
+        left.push_back(Rational64(static_cast<int64_t>(next() % 2000001) - 1000000, static_cast<int64_t>(next() % 1000000) + 1));
+        right.push_back(Rational64(static_cast<int64_t>(next() % 2000001) - 1000000, static_cast<int64_t>(next() % 1000000) + 1));
+    }
+    std::vector<int64_t> an(kPairs), ad(kPairs), bn(kPairs), bd(kPairs);
+    for (size_t i = 0; i < kPairs; ++i) {
+        an[i] = left[i].getNumerator();
+        ad[i] = left[i].getDenominator();
+        bn[i] = right[i].getNumerator();
+        bd[i] = right[i].getDenominator();
+    }
+    std::vector<int64_t> expectNum(kPairs), expectDen(kPairs), outNum(kPairs), outDen(kPairs);
+    std::vector<int8_t> expectOrder(kPairs), order(kPairs);
+    bool same = true;
+
+    auto ms = [](std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    };
+    auto matches = [&]() {
+        return outNum == expectNum && outDen == expectDen;
+    };
+    cout << "batch of " << kPairs << " fraction pairs (ms):\n";
+
+    // add and mul: objects, then batch reduced / raw (1 thread) / all cores
+    for (int op = 0; op < 2; ++op) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < kPairs; ++i) {
+            Rational64 r = left[i];
+            if (op == 0) r.add(bn[i], bd[i]);
+            else r.mul(bn[i], bd[i]);
+            expectNum[i] = r.getNumerator();
+            expectDen[i] = r.getDenominator();
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        size_t rejected = (op == 0) ? addBatch(an.data(), ad.data(), bn.data(), bd.data(), outNum.data(), outDen.data(), kPairs, true, 1)
+                                    : mulBatch(an.data(), ad.data(), bn.data(), bd.data(), outNum.data(), outDen.data(), kPairs, true, 1);
+        auto t2 = std::chrono::steady_clock::now();
+        same = same && rejected == 0 && matches();
+        rejected += (op == 0) ? addBatch(an.data(), ad.data(), bn.data(), bd.data(), outNum.data(), outDen.data(), kPairs, false, 1)
+                              : mulBatch(an.data(), ad.data(), bn.data(), bd.data(), outNum.data(), outDen.data(), kPairs, false, 1);
+        auto t3 = std::chrono::steady_clock::now();
+        rejected += normaliseBatch(outNum.data(), outDen.data(), kPairs);
+        same = same && rejected == 0 && matches();
+        auto t4 = std::chrono::steady_clock::now();
+        rejected += (op == 0) ? addBatch(an.data(), ad.data(), bn.data(), bd.data(), outNum.data(), outDen.data(), kPairs)
+                              : mulBatch(an.data(), ad.data(), bn.data(), bd.data(), outNum.data(), outDen.data(), kPairs);
+        auto t5 = std::chrono::steady_clock::now();
+        same = same && rejected == 0 && matches();
+        cout << (op == 0 ? "  add" : "  mul") << ": Rational64 " << ms(t0, t1) << ", batch " << ms(t1, t2)
+             << ", raw " << ms(t2, t3) << ", all cores " << ms(t4, t5) << "\n";
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kPairs; ++i) {
+        int128 l = int128(left[i].getNumerator()) * right[i].getDenominator();
+        int128 r = int128(right[i].getNumerator()) * left[i].getDenominator();
+        expectOrder[i] = static_cast<int8_t>((l > r) - (l < r));
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    size_t rejected = compareBatch(an.data(), ad.data(), bn.data(), bd.data(), order.data(), kPairs, 1);
+    auto t2 = std::chrono::steady_clock::now();
+    same = same && rejected == 0 && order == expectOrder;
+    cout << "  compare: objects " << ms(t0, t1) << ", batch " << ms(t1, t2) << "\n";
+
+    // sum: the mixed-units stream (denominators divide 720720)
+    const size_t kTerms = 10000000;
+    const int64_t kCommon = 720720;
+    std::vector<int64_t> divisors;
+    for (int64_t b = 1; b <= kCommon; ++b) {
+        if (kCommon % b == 0) divisors.push_back(b);
+    }
+    std::vector<int64_t> num(kTerms), den(kTerms);
+    for (size_t i = 0; i < kTerms; ++i) {
+        uint64_t x = next();
+        num[i] = static_cast<int64_t>(x % 2001) - 1000;
+        den[i] = divisors[(x >> 32) % divisors.size()];
+    }
+    auto t3 = std::chrono::steady_clock::now();
+    Rational64 sum(0, 1);
+    for (size_t i = 0; i < kTerms; ++i) sum.add(num[i], den[i]);
+    auto t4 = std::chrono::steady_clock::now();
+    Rational<BigInt> batchSum = sumBatch(num.data(), den.data(), kTerms, 1);
+    auto t5 = std::chrono::steady_clock::now();
+    Rational<BigInt> coreSum = sumBatch(num.data(), den.data(), kTerms);
+    auto t6 = std::chrono::steady_clock::now();
+    same = same && batchSum.getNumerator() == BigInt(sum.getNumerator()) &&
+           batchSum.getDenominator() == BigInt(sum.getDenominator()) &&
+           coreSum.getNumerator() == batchSum.getNumerator() && coreSum.getDenominator() == batchSum.getDenominator();
+    cout << "  sum of " << kTerms << ": Rational64::add " << ms(t3, t4) << ", sumBatch " << ms(t4, t5)
+         << ", all cores " << ms(t5, t6) << " (" << std::max(1U, std::thread::hardware_concurrency()) << " threads)\n";
+    cout << "  results match: " << (same ? "yes" : "NO") << "\n";
+    return same ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+        long long count = (argc > 2) ? std::atoll(argv[2]) : 100000000LL;
+        int status = benchmarkRational(count > 0 ? count : 1);
+        status |= benchmarkBigRational();
+        return benchmarkBatch() | status;
+    }
+
+    auto show = [](const char* label, const auto& r) {
         cout << "\n=== " << label << " ===\n";
         r.printRationalForm();
         r.printFloatingPointForm();
     };
 
-    Rational r1(2, 4);
+    Rational64 r1(2, 4);
     show("Construct 2/4 (expect 1/2)", r1);
 
-    Rational r2(1, -2);
+    Rational64 r2(1, -2);
     show("Construct 1/-2 (expect -1/2)", r2);
 
-    Rational r3(-1, -2);
+    Rational64 r3(-1, -2);
     show("Construct -1/-2 (expect 1/2)", r3);
 
-    Rational r4(0, 5);
+    Rational64 r4(0, 5);
     show("Construct 0/5 (expect 0/1)", r4);
 
-    Rational r5(1, 2);
+    Rational64 r5(1, 2);
     r5.add(1, 2);
     show("1/2 + 1/2 (expect 1/1)", r5);
 
-    Rational r6(3, 4);
+    Rational64 r6(3, 4);
     r6.sub(1, 2);
     show("3/4 - 1/2 (expect 1/4)", r6);
 
-    Rational r7(2, 3);
+    Rational64 r7(2, 3);
     r7.mul(9, 4);
     show("2/3 * 9/4 (expect 3/2)", r7);
 
-    Rational r8(3, 5);
+    Rational64 r8(3, 5);
     r8.div(9, 10);
     show("3/5 ÷ 9/10 (expect 2/3)", r8);
 
-    Rational r9(1, 2);
+    Rational64 r9(1, 2);
     r9.div(0, 7);
     show("1/2 ÷ 0/7 (expect unchanged + error)", r9);
 
-    Rational r10(5, 0);
+    Rational64 r10(5, 0);
     show("Construct 5/0 (expect error + safe)", r10);
 
+    Rational64 r11(46341, 1);
+    r11.mul(46341, 1);
+    show("46341 * 46341 (int overflowed; expect 2147488281/1)", r11);
+
+    Rational64 r12(1, 3000000000LL);
+    r12.add(1, 6000000000LL);
+    show("1/3e9 + 1/6e9 (expect 1/2000000000)", r12);
+
+    Rational64 r13(1, 4294967296LL);
+    r13.mul(1, 4294967296LL);
+    show("1/2^32 * 1/2^32 (expect overflow error, unchanged)", r13);
+
+    Rational64 r14(6, 35);
+    r14.mul(14, 15);
+    show("6/35 * 14/15 (cancels to 4/25 before multiplying)", r14);
+
+    // Rational<BigInt>: same interface, exact at any size
+    Rational<BigInt> b1(1, 3);
+    for (int i = 1; i < 50; ++i) b1.mul(1, 3);
+    show("(1/3)^50 with BigInt (expect 1/717897987691852588770249)", b1);
+
+    Rational64 r15(1, 3);
+    for (int i = 1; i < 50; ++i) r15.mul(1, 3);
+    show("(1/3)^50 with Rational64 (expect overflow errors, stops at 1/3^39)", r15);
+
+    Rational<BigInt> b4(INT64_MAX, 1);
+    b4.add(1, 1);
+    show("INT64_MAX + 1 with BigInt (one 64-bit limb; expect 9223372036854775808/1)", b4);
+
+    Rational<BigInt> b2(0, 1);
+    for (int k = 1; k <= 30; ++k) b2.add(1, k);
+    show("1 + 1/2 + ... + 1/30 (expect 9304682830147/2329089562800)", b2);
+
+    Rational<BigInt> b3(0, 100);
+    double drift = 0.0;
+    for (int i = 0; i < 1000000; ++i) {
+        b3.add(10, 100);   // ten cents
+        drift += 0.10;
+    }
+    show("1000000 x 0.10 (expect 100000/1)", b3);
+    cout << "same sum in double: " << std::setprecision(6) << drift << "\n";
+
+    // batch kernels: fractions as two arrays (numerators, denominators)
+    int64_t an[] = {1, 1, 3, -5, 7, INT64_MAX};
+    int64_t ad[] = {2, 3, 4, 6, 10, 1};
+    int64_t bn[] = {1, 1, 1, 1, 3, 1};
+    int64_t bd[] = {2, 6, 4, 3, 10, 1};
+    int64_t sumNum[6], sumDen[6], prodNum[6], prodDen[6];
+    int8_t order[6];
+    size_t overflowed = addBatch(an, ad, bn, bd, sumNum, sumDen, 6);
+    mulBatch(an, ad, bn, bd, prodNum, prodDen, 6);
+    compareBatch(an, ad, bn, bd, order, 6);
+    cout << "\n=== addBatch (expect 1/1 1/2 1/1 -1/2 1/1 0/0, 1 overflowed) ===\n";
+    for (int i = 0; i < 6; ++i) cout << sumNum[i] << "/" << sumDen[i] << " ";
+    cout << "\noverflowed: " << overflowed << "\n";
+    cout << "\n=== mulBatch (expect 1/4 1/18 3/16 -5/18 21/100 9223372036854775807/1) ===\n";
+    for (int i = 0; i < 6; ++i) cout << prodNum[i] << "/" << prodDen[i] << " ";
+    cout << "\n\n=== compareBatch (expect 0 1 1 -1 1 1) ===\n";
+    for (int i = 0; i < 6; ++i) cout << static_cast<int>(order[i]) << " ";
+    cout << "\n";
+    show("sumBatch of the first 5 (expect 29/20)", sumBatch(an, ad, 5));
+
     return 0;
 }
@@ -1,97 +1,364 @@
 #include <iostream>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <type_traits>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <memory>
+
+#if defined(__AVX2__) || defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
 using namespace std;
 
 /*
 ===============================================================================
-EX 9: IntegerSet (0..100) using a boolean membership array
+EX 9: IntegerSet (0..100 by default, any 0..N universe) as a packed bitset
 
 Core representation:
-  - bool set[101]
-  - set[i] == true  => integer i is IN the set
-  - set[i] == false => integer i is NOT in the set
+  - vector<uint64_t> words; integer k lives in word k / 64, bit k % 64
+  - bit set   => integer k is IN the set
+  - bit clear => integer k is NOT in the set
+  - started as bool set[101] (1 byte per value); 64 values per word is 8x
+    smaller and lets one instruction handle 64 (or 256 with AVX2) values.
+  - bits above maxValue in the last word are always 0, so whole-word
+    operations never invent members.
 
 Key learnings / rules we proved:
   1) Set equality:
-       S == T  <=>  for every i in [0..100], membership matches
-       Implementation: scan all indices; first mismatch => not equal.
+       S == T  <=>  for every i in [0..N], membership matches
+       Implementation: memcmp on the words (stops at the first differing
+       byte); a longer universe must have only zero words past the common part.
   2) Union:
        S ∪ T = { i | i in S OR i in T }
-       Implementation: result[i] = this[i] || other[i]
+       Implementation: result.word[w] = this.word[w] | other.word[w]
   3) Intersection:
        S ∩ T = { i | i in S AND i in T }
-       Implementation: result[i] = this[i] && other[i]
-  4) Constructor ambiguity pitfall:
+       Implementation: result.word[w] = this.word[w] & other.word[w]
+  4) Difference / symmetric difference:
+       S - T = S AND NOT T,   S △ T = S XOR T   (same word-at-a-time loop)
+  5) Cardinality = sum of popcount(word) - no per-element loop.
+  6) Constructor ambiguity pitfall:
        If you have BOTH:
          IntegerSet()
          IntegerSet(int a=-1, ..., int e=-1)
        then calling IntegerSet x; is ambiguous (both match 0 args).
        Fix: keep only ONE constructor (the 5-arg with defaults).
-  5) API design:
+       A bigger universe therefore comes from a named factory,
+       IntegerSet::withUniverse(maxValue), not from another constructor
+       (IntegerSet(1000) would silently mean "the set {1000}").
+  7) API design:
        insert/delete return bool instead of printing inside the class
        -> caller decides how to handle invalid inputs.
+  8) Mixed universes: operations on sets of different sizes behave as if
+     the smaller set had zeros up to the larger maxValue; the result uses
+     the larger universe.
+  9) Results without temporaries:
+       a |= b, a &= b, a -= b, a ^= b        work in place
+       a.unionOfIntegerSets(b, result)       reuses result's storage
+       IntegerSet r = a | b | c & d;         lazy expression, ONE pass
+     a | b builds a small SetExpr node (references, no words); the words
+     are only computed when the expression is assigned to an IntegerSet,
+     so a chain of k operations reads each input word once and writes
+     each output word once instead of k full passes and k - 1 temporaries.
+     Pitfall: an expression refers to its operands, so do not keep one in
+     an `auto` variable past the sets (or temporaries) it was built from.
+ 10) Ordered walks and rank/select:
+       for (int k : set)  visits members only: TZCNT finds the lowest set
+                          bit, BLSR (w & (w - 1)) clears it, zero words are
+                          skipped with one load each.
+       rank(x)   = number of members < x
+       select(k) = k-th smallest member (0-based), -1 if there is none
+     Both use a prefix popcount per 512-bit superblock (4 bytes per 512
+     values), so a query touches one index entry and at most 8 words.
+     The index is rebuilt lazily by the first query after a change.
 ===============================================================================
 */
 
+class IntegerSet;
+
+// Tag base of every lazy set expression (a | b, a & b, ...), see SetExpr
+struct SetExprBase {};
+
+template<class T>
+struct IsSetOperand
+    : integral_constant<bool, is_same<T, IntegerSet>::value || is_base_of<SetExprBase, T>::value> {};
+
 class IntegerSet {
 private:
-    bool set[101]; // index represents the integer; value represents membership
+    int maxValue;             // universe is 0..maxValue
+    vector<uint64_t> words;   // bit k % 64 of words[k / 64] = membership of k
+
+    // rank/select index: superblockRanks[b] = members in words [0, 8b),
+    // last entry = total; only valid while ranksStale is false
+    static const size_t kWordsPerSuperblock = 8;
+    mutable vector<uint32_t> superblockRanks;
+    mutable bool ranksStale = true;
 
-    void fillZero() {
-        for (int i = 0; i <= 100; ++i) {
-            set[i] = false;
+    void rebuildRanks() const {
+        size_t blocks = (words.size() + kWordsPerSuperblock - 1) / kWordsPerSuperblock;
+        superblockRanks.assign(blocks + 1, 0);
+        uint32_t total = 0;
+        for (size_t b = 0; b < blocks; ++b) {
+            superblockRanks[b] = total;
+            size_t end = min(words.size(), (b + 1) * kWordsPerSuperblock);
+            for (size_t i = b * kWordsPerSuperblock; i < end; ++i) {
+                total += static_cast<uint32_t>(__builtin_popcountll(words[i]));
+            }
         }
+        superblockRanks[blocks] = total;
+        ranksStale = false;
+    }
+
+    // position of the r-th set bit of w (r < popcount(w)); PDEP deposits a
+    // single 1 onto that bit when BMI2 is available
+    static int selectInWord(uint64_t w, unsigned r) {
+#if defined(__BMI2__)
+        return __builtin_ctzll(_pdep_u64(uint64_t(1) << r, w));
+#else
+        for (; r > 0; --r) w &= w - 1;
+        return __builtin_ctzll(w);
+#endif
+    }
+
+    static size_t wordsFor(int maxValue) { return static_cast<size_t>(maxValue) / 64 + 1; }
+
+    friend class SetRef;
+
+    template<class T>
+    using EnableIfExpression = typename enable_if<is_base_of<SetExprBase, T>::value>::type;
+    template<class T>
+    using EnableIfOperand = typename enable_if<IsSetOperand<T>::value>::type;
+
+    // dst[i] = e.word(i) for i < n; every operand has at least `dense` words,
+    // so only the tail needs the "past the end reads as 0" check.
+    template<class E>
+    static void evaluateWords(uint64_t* dst, const E& e, size_t dense, size_t n) {
+        size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 4 <= dense; i += 4) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), e.block(i));
+        }
+#endif
+        for (; i < dense; ++i) dst[i] = e.word(i);
+        for (; i < n; ++i) dst[i] = e.wordOrZero(i);
+    }
+
+    // One pass over the words, result over the largest universe in e.
+    // Word i of the result only reads word i of each operand, so *this may
+    // itself be an operand (a = a | b). Storage is reused when it is big
+    // enough; growing in place only appends zero words, which an operand
+    // that is *this then reads as its (zero) tail.
+    template<class E>
+    void assignExpression(const E& e) {
+        int newMax = e.universeMax();
+        size_t n = wordsFor(newMax);
+        size_t dense = e.denseWords();   // measured before *this is resized
+        if (n > words.capacity()) {
+            vector<uint64_t> fresh(n);
+            evaluateWords(fresh.data(), e, dense, n);
+            words.swap(fresh);
+        } else {
+            words.resize(n);
+            evaluateWords(words.data(), e, dense, n);
+        }
+        maxValue = newMax;
+        ranksStale = true;
     }
 
 public:
     // Single constructor: also serves as the "default" empty-set constructor
-    IntegerSet(int a = -1, int b = -1, int c = -1, int d = -1, int e = -1) {
-        fillZero();
-        if (a >= 0 && a <= 100) set[a] = true;
-        if (b >= 0 && b <= 100) set[b] = true;
-        if (c >= 0 && c <= 100) set[c] = true;
-        if (d >= 0 && d <= 100) set[d] = true;
-        if (e >= 0 && e <= 100) set[e] = true;
+    IntegerSet(int a = -1, int b = -1, int c = -1, int d = -1, int e = -1)
+        : maxValue(100), words(wordsFor(100), 0) {
+        insertElement(a);
+        insertElement(b);
+        insertElement(c);
+        insertElement(d);
+        insertElement(e);
+    }
+
+    // Empty set over 0..maxValue (any size; memory = (maxValue + 1) / 8 bytes)
+    static IntegerSet withUniverse(int maxValue) {
+        IntegerSet s;
+        s.maxValue = (maxValue < 0) ? 0 : maxValue;
+        s.words.assign(wordsFor(s.maxValue), 0);
+        s.ranksStale = true;
+        return s;
+    }
+
+    // Lazy results (a | b | c & d, see SetExpr below) materialise here in one pass
+    template<class E, class = EnableIfExpression<E>>
+    IntegerSet(const E& e) : maxValue(0) {
+        assignExpression(e);
     }
 
+    template<class E, class = EnableIfExpression<E>>
+    IntegerSet& operator=(const E& e) {
+        assignExpression(e);
+        return *this;
+    }
+
+    // In place: no new set is built; the right side may be a set or an expression
+    template<class T, class = EnableIfOperand<T>>
+    IntegerSet& operator|=(const T& other) { return *this = (*this | other); }
+
+    template<class T, class = EnableIfOperand<T>>
+    IntegerSet& operator&=(const T& other) { return *this = (*this & other); }
+
+    template<class T, class = EnableIfOperand<T>>
+    IntegerSet& operator-=(const T& other) { return *this = (*this - other); }
+
+    template<class T, class = EnableIfOperand<T>>
+    IntegerSet& operator^=(const T& other) { return *this = (*this ^ other); }
+
+    int universeMax() const { return maxValue; }
+
     bool insertElement(int k) {
-        if (k >= 0 && k <= 100) {
-            set[k] = true;
+        if (k >= 0 && k <= maxValue) {
+            words[static_cast<size_t>(k) / 64] |= uint64_t(1) << (k % 64);
+            ranksStale = true;
             return true;
         }
         return false;
     }
 
     bool deleteElement(int k) {
-        if (k >= 0 && k <= 100) {
-            set[k] = false;
+        if (k >= 0 && k <= maxValue) {
+            words[static_cast<size_t>(k) / 64] &= ~(uint64_t(1) << (k % 64));
+            ranksStale = true;
             return true;
         }
         return false;
     }
 
+    bool hasElement(int k) const {
+        return k >= 0 && k <= maxValue && ((words[static_cast<size_t>(k) / 64] >> (k % 64)) & 1) != 0;
+    }
+
+    // number of members: one popcount per 64 values
+    size_t cardinality() const {
+        size_t count = 0;
+        for (uint64_t w : words) {
+            count += static_cast<size_t>(__builtin_popcountll(w));
+        }
+        return count;
+    }
+
     bool isEqual(const IntegerSet& other) const {
-        for (int i = 0; i <= 100; ++i) {
-            if (set[i] != other.set[i]) {
+        size_t common = min(words.size(), other.words.size());
+        if (memcmp(words.data(), other.words.data(), common * sizeof(uint64_t)) != 0) {
+            return false;
+        }
+        const vector<uint64_t>& longer = (words.size() > common) ? words : other.words;
+        for (size_t i = common; i < longer.size(); ++i) {
+            if (longer[i] != 0) {
                 return false;
             }
         }
         return true;
     }
 
-    IntegerSet unionOfIntegerSets(const IntegerSet& other) const {
-        IntegerSet result; // empty set via defaults
-        for (int i = 0; i <= 100; ++i) {
-            result.set[i] = set[i] || other.set[i];
+    // By value (a new set), or into a caller-owned result whose storage is
+    // reused across calls; result may be *this or other. Defined after SetExpr.
+    IntegerSet unionOfIntegerSets(const IntegerSet& other) const;
+    void unionOfIntegerSets(const IntegerSet& other, IntegerSet& result) const;
+
+    IntegerSet intersectionOfIntegerSets(const IntegerSet& other) const;
+    void intersectionOfIntegerSets(const IntegerSet& other, IntegerSet& result) const;
+
+    // members of this set that are not in other
+    IntegerSet differenceOfIntegerSets(const IntegerSet& other) const;
+    void differenceOfIntegerSets(const IntegerSet& other, IntegerSet& result) const;
+
+    // members in exactly one of the two sets
+    IntegerSet symmetricDifferenceOfIntegerSets(const IntegerSet& other) const;
+    void symmetricDifferenceOfIntegerSets(const IntegerSet& other, IntegerSet& result) const;
+
+    // Members in increasing order; only set bits are visited (ctz finds
+    // the lowest one, w & (w - 1) clears it). Invalidated by any change.
+    class const_iterator {
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = int;
+        using difference_type = ptrdiff_t;
+        using pointer = const int*;
+        using reference = int;
+
+        const_iterator() : words(nullptr), count(0), index(0), current(0) {}
+        const_iterator(const uint64_t* words, size_t count, size_t index)
+            : words(words), count(count), index(index), current(index < count ? words[index] : 0) {
+            skipEmptyWords();
         }
-        return result;
+
+        int operator*() const { return static_cast<int>(index * 64 + static_cast<size_t>(__builtin_ctzll(current))); }
+
+        const_iterator& operator++() {
+            current &= current - 1;
+            skipEmptyWords();
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator before = *this;
+            ++*this;
+            return before;
+        }
+
+        bool operator==(const const_iterator& other) const { return index == other.index && current == other.current; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        const uint64_t* words;
+        size_t count;
+        size_t index;       // word holding the current member (count at the end)
+        uint64_t current;   // members of words[index] not visited yet
+
+        void skipEmptyWords() {
+            while (current == 0 && index < count) {
+                if (++index < count) current = words[index];
+            }
+        }
+    };
+
+    const_iterator begin() const { return const_iterator(words.data(), words.size(), 0); }
+    const_iterator end() const { return const_iterator(words.data(), words.size(), words.size()); }
+
+    // number of members < x
+    size_t rank(int x) const {
+        if (x <= 0) return 0;
+        if (ranksStale) rebuildRanks();
+        if (x > maxValue) return superblockRanks.back();
+        size_t w = static_cast<size_t>(x) / 64;
+        size_t count = superblockRanks[w / kWordsPerSuperblock];
+        for (size_t i = w - w % kWordsPerSuperblock; i < w; ++i) {
+            count += static_cast<size_t>(__builtin_popcountll(words[i]));
+        }
+        uint64_t below = (uint64_t(1) << (x % 64)) - 1;
+        return count + static_cast<size_t>(__builtin_popcountll(words[w] & below));
     }
 
-    IntegerSet intersectionOfIntegerSets(const IntegerSet& other) const {
-        IntegerSet result; // empty set via defaults
-        for (int i = 0; i <= 100; ++i) {
-            result.set[i] = set[i] && other.set[i];
+    // k-th smallest member (k = 0 is the minimum), -1 if k >= cardinality()
+    int select(size_t k) const {
+        if (ranksStale) rebuildRanks();
+        if (k >= superblockRanks.back()) return -1;
+        // last superblock starting at rank <= k holds the answer
+        size_t b = static_cast<size_t>(upper_bound(superblockRanks.begin(), superblockRanks.end(), k)
+                                       - superblockRanks.begin()) - 1;
+        size_t left = k - superblockRanks[b];
+        for (size_t i = b * kWordsPerSuperblock;; ++i) {
+            size_t inWord = static_cast<size_t>(__builtin_popcountll(words[i]));
+            if (left < inWord) {
+                return static_cast<int>(i * 64) + selectInWord(words[i], static_cast<unsigned>(left));
+            }
+            left -= inWord;
         }
-        return result;
     }
 
     // Print as required by exercise:
@@ -99,20 +366,1443 @@ public:
     // - print --- if empty
     void setPrint() const {
         bool isEmpty = true;
-        for (int i = 0; i <= 100; ++i) {
-            if (set[i]) {
-                cout << i << " ";
-                isEmpty = false;
+        for (int k : *this) {
+            cout << k << " ";
+            isEmpty = false;
+        }
+        if (isEmpty) {
+            cout << "---";
+        }
+        cout << "\n";
+    }
+};
+
+/*
+===============================================================================
+Lazy set expressions (expression templates)
+
+  a | b | c & d  has type  SetExpr<SetOr, SetExpr<SetOr, SetRef, SetRef>,
+                                   SetExpr<SetAnd, SetRef, SetRef>>
+  (& binds tighter than |, as for integers). Each node answers "what is
+  word i of my result?" by asking its children, so after inlining the
+  whole tree becomes one loop body:  dst[i] = a[i] | b[i] | (c[i] & d[i]).
+  With AVX2 the same tree is evaluated on 4 words (256 values) at a time.
+
+  universeMax = largest operand universe, denseWords = smallest operand
+  word count; below denseWords no bounds checks are needed.
+===============================================================================
+*/
+
+// Leaf: one IntegerSet, read in place
+class SetRef {
+public:
+    SetRef(const IntegerSet& s) : set(&s) {}
+
+    int universeMax() const { return set->maxValue; }
+    size_t denseWords() const { return set->words.size(); }
+    uint64_t word(size_t i) const { return set->words[i]; }
+    uint64_t wordOrZero(size_t i) const { return (i < set->words.size()) ? set->words[i] : 0; }
+#if defined(__AVX2__)
+    __m256i block(size_t i) const {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(set->words.data() + i));
+    }
+#endif
+
+private:
+    const IntegerSet* set;
+};
+
+struct SetOr {
+    static uint64_t apply(uint64_t x, uint64_t y) { return x | y; }
+#if defined(__AVX2__)
+    static __m256i apply(__m256i x, __m256i y) { return _mm256_or_si256(x, y); }
+#endif
+};
+
+struct SetAnd {
+    static uint64_t apply(uint64_t x, uint64_t y) { return x & y; }
+#if defined(__AVX2__)
+    static __m256i apply(__m256i x, __m256i y) { return _mm256_and_si256(x, y); }
+#endif
+};
+
+struct SetAndNot {
+    static uint64_t apply(uint64_t x, uint64_t y) { return x & ~y; }
+#if defined(__AVX2__)
+    static __m256i apply(__m256i x, __m256i y) { return _mm256_andnot_si256(y, x); }   // x & ~y
+#endif
+};
+
+struct SetXor {
+    static uint64_t apply(uint64_t x, uint64_t y) { return x ^ y; }
+#if defined(__AVX2__)
+    static __m256i apply(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+#endif
+};
+
+// Inner node: children are held by value (they are only refs and nodes)
+template<class OpTag, class L, class R>
+class SetExpr : public SetExprBase {
+public:
+    SetExpr(const L& l, const R& r) : left(l), right(r) {}
+
+    int universeMax() const { return max(left.universeMax(), right.universeMax()); }
+    size_t denseWords() const { return min(left.denseWords(), right.denseWords()); }
+    uint64_t word(size_t i) const { return OpTag::apply(left.word(i), right.word(i)); }
+    uint64_t wordOrZero(size_t i) const { return OpTag::apply(left.wordOrZero(i), right.wordOrZero(i)); }
+#if defined(__AVX2__)
+    __m256i block(size_t i) const { return OpTag::apply(left.block(i), right.block(i)); }
+#endif
+
+private:
+    L left;
+    R right;
+};
+
+// IntegerSet operands become SetRef leaves, expressions nest as they are
+template<class T>
+using SetNode = typename conditional<is_same<T, IntegerSet>::value, SetRef, T>::type;
+
+template<class A, class B>
+using EnableIfSetOperands = typename enable_if<IsSetOperand<A>::value && IsSetOperand<B>::value>::type;
+
+template<class A, class B, class = EnableIfSetOperands<A, B>>
+SetExpr<SetOr, SetNode<A>, SetNode<B>> operator|(const A& a, const B& b) { return {a, b}; }
+
+template<class A, class B, class = EnableIfSetOperands<A, B>>
+SetExpr<SetAnd, SetNode<A>, SetNode<B>> operator&(const A& a, const B& b) { return {a, b}; }
+
+template<class A, class B, class = EnableIfSetOperands<A, B>>
+SetExpr<SetAndNot, SetNode<A>, SetNode<B>> operator-(const A& a, const B& b) { return {a, b}; }
+
+template<class A, class B, class = EnableIfSetOperands<A, B>>
+SetExpr<SetXor, SetNode<A>, SetNode<B>> operator^(const A& a, const B& b) { return {a, b}; }
+
+// The named operations are single-node expressions; the returned set is
+// built directly in the caller's variable (no extra copy or move).
+IntegerSet IntegerSet::unionOfIntegerSets(const IntegerSet& other) const { return *this | other; }
+IntegerSet IntegerSet::intersectionOfIntegerSets(const IntegerSet& other) const { return *this & other; }
+IntegerSet IntegerSet::differenceOfIntegerSets(const IntegerSet& other) const { return *this - other; }
+IntegerSet IntegerSet::symmetricDifferenceOfIntegerSets(const IntegerSet& other) const { return *this ^ other; }
+
+void IntegerSet::unionOfIntegerSets(const IntegerSet& other, IntegerSet& result) const {
+    result = *this | other;
+}
+void IntegerSet::intersectionOfIntegerSets(const IntegerSet& other, IntegerSet& result) const {
+    result = *this & other;
+}
+void IntegerSet::differenceOfIntegerSets(const IntegerSet& other, IntegerSet& result) const {
+    result = *this - other;
+}
+void IntegerSet::symmetricDifferenceOfIntegerSets(const IntegerSet& other, IntegerSet& result) const {
+    result = *this ^ other;
+}
+
+/*
+===============================================================================
+ConcurrentIntegerSet: one membership set shared by many producer threads
+
+Writers (lock-free: never wait for a reader or for each other):
+  - each 64-bit word holds 32 members (low half) and a version (high half):
+    2 bits per id, twice the memory of IntegerSet
+  - a write is ONE compare-exchange on that word: set/clear the bit and add
+    1 to the version together. Two threads changing bits of the same word
+    never lose an update (words[w] |= bit on a plain vector would: both
+    read the old word, the second store wins); a failed exchange means
+    another write landed, so it retries with the word it got back.
+  - fetch_or / fetch_and would be the cheaper RMW, but they cannot bump the
+    version, and the version is what readers validate against.
+  - a write that would not change the word (insert of a member, delete of
+    a non-member) is just the load: hot ids stop bouncing their line.
+Readers:
+  - hasElement is a single atomic load: each answer is current, but two
+    answers are not from the same instant.
+  - snapshot() copies the words without stopping writers and validates the
+    copy by versions (an epoch per word): a word whose version did not move
+    between two reads held that value the whole time in between (unless
+    exactly 2^32 writes hit that word in between).
+      1) start from the words of the previous copy (or one pass)
+      2) re-read the words that changed before ("hot" words) twice in a row
+         until both reads agree: they held those values at one instant T
+      3) one pass over all other words: unchanged since their last read
+         (which was before T) means they also held their value at T. Words
+         that did change become hot, and we go back to 2).
+    Only the hot words are re-read until they agree, so a copy finishes
+    under a steady write stream; writes that keep hitting the same few
+    words only make step 2 spin on those words.
+  - the copy's epoch changes whenever the set changed since the previous
+    copy; with an unchanged set the previous copy (and its rank index) is
+    handed out again.
+  - unionOfIntegerSets / intersectionOfIntegerSets copy BOTH sets in one
+    validation, so both copies come from the same instant (an id moved
+    from one set to the other is never missed or seen twice).
+  - one copy per set is taken at a time (readerMutex); writers never touch
+    that mutex.
+Padding:
+  - Packed : 8 words (256 ids) per 64-byte cache line
+  - PerWord: each word on its own cache line (8x memory). Writers hitting
+    nearby ids no longer bounce one line between cores (false sharing);
+    writers hitting the SAME word still do (true sharing).
+===============================================================================
+*/
+class ConcurrentIntegerSet {
+private:
+    static const int kIdsPerWord = 32;
+    static const uint64_t kMemberBits = 0xFFFFFFFFULL;
+    static const uint64_t kVersionOne = uint64_t(1) << 32;
+
+    struct alignas(64) CacheLine {
+        atomic<uint64_t> word[8];
+    };
+
+    int maxValue;
+    size_t wordCount;
+    unsigned lineShift;   // 3: 8 words per line, 0: 1 word per line
+    unique_ptr<CacheLine[]> lines;
+    mutable mutex readerMutex;              // one copy at a time
+    mutable vector<uint64_t> cachedWords;   // versioned words behind `cached`
+    mutable shared_ptr<const IntegerSet> cached;
+    mutable uint64_t cachedEpoch;
+
+    atomic<uint64_t>& word(size_t i) const {
+        return lines[i >> lineShift].word[i & ((size_t(1) << lineShift) - 1)];
+    }
+
+    void writeBit(int k, bool member) {
+        atomic<uint64_t>& w = word(static_cast<size_t>(k) / kIdsPerWord);
+        uint64_t bit = uint64_t(1) << (k % kIdsPerWord);
+        uint64_t old = w.load();
+        while (((old & bit) != 0) != member) {
+            uint64_t changed = member ? (old | bit) : (old & ~bit);
+            if (w.compare_exchange_weak(old, changed + kVersionOne)) return;
+        }
+    }
+
+    // Expression leaf over a validated copy of the versioned words (see
+    // SetExpr): two 32-member halves make one IntegerSet word
+    class CopyView : public SetExprBase {
+    public:
+        CopyView(const vector<uint64_t>& copy, int maxValue) : copy(copy), maxValue(maxValue) {}
+
+        int universeMax() const { return maxValue; }
+        size_t denseWords() const { return static_cast<size_t>(maxValue) / 64 + 1; }
+        uint64_t word(size_t i) const {
+            uint64_t low = copy[2 * i] & kMemberBits;
+            uint64_t high = (2 * i + 1 < copy.size()) ? copy[2 * i + 1] & kMemberBits : 0;
+            return low | (high << 32);
+        }
+        uint64_t wordOrZero(size_t i) const { return (i < denseWords()) ? word(i) : 0; }
+#if defined(__AVX2__)
+        __m256i block(size_t i) const {
+            return _mm256_set_epi64x(static_cast<long long>(word(i + 3)), static_cast<long long>(word(i + 2)),
+                                     static_cast<long long>(word(i + 1)), static_cast<long long>(word(i)));
+        }
+#endif
+
+    private:
+        const vector<uint64_t>& copy;
+        int maxValue;
+    };
+
+    // copies[s] = the versioned words of sets[s], all at one instant (see
+    // Readers above). Caller holds each set's readerMutex.
+    static void copyAtOneInstant(const ConcurrentIntegerSet* const sets[], vector<uint64_t> copies[], size_t count) {
+        vector<vector<uint8_t>> isHot(count);
+        vector<pair<size_t, size_t>> hot;   // (set, word)
+        vector<uint64_t> first, second;
+        for (size_t s = 0; s < count; ++s) {
+            const ConcurrentIntegerSet& set = *sets[s];
+            copies[s] = set.cachedWords;
+            if (copies[s].size() != set.wordCount) {
+                copies[s].resize(set.wordCount);
+                for (size_t i = 0; i < set.wordCount; ++i) copies[s][i] = set.word(i).load();
+            }
+            isHot[s].assign(set.wordCount, 0);
+        }
+        for (;;) {
+            for (;;) {
+                first.clear();
+                second.clear();
+                for (const pair<size_t, size_t>& h : hot) first.push_back(sets[h.first]->word(h.second).load());
+                for (const pair<size_t, size_t>& h : hot) second.push_back(sets[h.first]->word(h.second).load());
+                if (first == second) break;
+                this_thread::yield();
+            }
+
+            bool stable = true;
+            for (size_t s = 0; s < count; ++s) {
+                const ConcurrentIntegerSet& set = *sets[s];
+                for (size_t i = 0; i < set.wordCount; ++i) {
+                    if (isHot[s][i]) continue;
+                    uint64_t now = set.word(i).load();
+                    if (now != copies[s][i]) {
+                        isHot[s][i] = 1;
+                        hot.push_back({s, i});
+                        stable = false;
+                    }
+                }
+            }
+            if (stable) break;
+        }
+        for (size_t h = 0; h < hot.size(); ++h) copies[hot[h].first][hot[h].second] = second[h];
+    }
+
+public:
+    enum class Padding { Packed, PerWord };
+
+    struct Snapshot {
+        shared_ptr<const IntegerSet> set;
+        uint64_t epoch;
+    };
+
+private:
+    // caller holds readerMutex; words = a copy from copyAtOneInstant
+    Snapshot publish(vector<uint64_t>& words) const {
+        if (!cached || words != cachedWords) {
+            shared_ptr<IntegerSet> fresh = make_shared<IntegerSet>(CopyView(words, maxValue));
+            // build the rank index before the copy is shared: rank()/select()
+            // on a stale index would rebuild it, a write from many readers
+            fresh->select(0);
+            cached = fresh;
+            cachedWords.swap(words);
+            ++cachedEpoch;
+        }
+        return {cached, cachedEpoch};
+    }
+
+public:
+    explicit ConcurrentIntegerSet(int maxValue, Padding padding = Padding::Packed)
+        : maxValue(maxValue < 0 ? 0 : maxValue),
+          wordCount(static_cast<size_t>(this->maxValue) / kIdsPerWord + 1),
+          lineShift(padding == Padding::Packed ? 3 : 0),
+          lines(new CacheLine[((wordCount - 1) >> lineShift) + 1]),
+          cachedEpoch(0) {
+        for (size_t i = 0; i < wordCount; ++i) word(i).store(0, memory_order_relaxed);
+    }
+
+    int universeMax() const { return maxValue; }
+
+    bool insertElement(int k) {
+        if (k < 0 || k > maxValue) return false;
+        writeBit(k, true);
+        return true;
+    }
+
+    bool deleteElement(int k) {
+        if (k < 0 || k > maxValue) return false;
+        writeBit(k, false);
+        return true;
+    }
+
+    bool hasElement(int k) const {
+        return k >= 0 && k <= maxValue &&
+               ((word(static_cast<size_t>(k) / kIdsPerWord).load() >> (k % kIdsPerWord)) & 1) != 0;
+    }
+
+    // the set at one instant (shared, immutable)
+    Snapshot snapshot() const {
+        lock_guard<mutex> lock(readerMutex);
+        const ConcurrentIntegerSet* self = this;
+        vector<uint64_t> words;
+        copyAtOneInstant(&self, &words, 1);
+        return publish(words);
+    }
+
+    // snapshots of two sets from the same instant
+    static pair<Snapshot, Snapshot> snapshotPair(const ConcurrentIntegerSet& a, const ConcurrentIntegerSet& b) {
+        if (&a == &b) {
+            Snapshot both = a.snapshot();
+            return {both, both};
+        }
+        unique_lock<mutex> lockA(a.readerMutex, defer_lock);
+        unique_lock<mutex> lockB(b.readerMutex, defer_lock);
+        lock(lockA, lockB);
+        const ConcurrentIntegerSet* sets[2] = {&a, &b};
+        vector<uint64_t> words[2];
+        copyAtOneInstant(sets, words, 2);
+        return {a.publish(words[0]), b.publish(words[1])};
+    }
+
+    IntegerSet unionOfIntegerSets(const ConcurrentIntegerSet& other) const {
+        pair<Snapshot, Snapshot> s = snapshotPair(*this, other);
+        return *s.first.set | *s.second.set;
+    }
+
+    IntegerSet intersectionOfIntegerSets(const ConcurrentIntegerSet& other) const {
+        pair<Snapshot, Snapshot> s = snapshotPair(*this, other);
+        return *s.first.set & *s.second.set;
+    }
+};
+
+/*
+===============================================================================
+CompressedIntegerSet: Roaring-style set of 32-bit integers
+
+Why:
+  - A dense bitset costs (maxValue + 1) / 8 bytes no matter how many members:
+    a 2^32 universe is 512 MB even for 10 members.
+  - bool[101]-style tricks only work for tiny universes.
+
+Representation (same idea as Roaring bitmaps):
+  - split a value into high 16 bits (chunk key) and low 16 bits
+  - only non-empty chunks are stored, sorted by key, and each chunk picks
+    the cheapest container for its 65536-value range:
+      Array  : sorted uint16 list          (<= 4096 members, 2 bytes each)
+      Bitmap : 1024 x uint64 = 8 KB        (> 4096 members)
+      Run    : sorted (start, length - 1)  (long consecutive stretches)
+    4096 is the break-even point: 4096 * 2 bytes == 8 KB.
+  - Array/Bitmap are kept automatically on insert/delete; runOptimize()
+    switches chunks to Run where that is smaller (runs are never needed
+    for correctness, only for size).
+
+Set algebra works chunk by chunk (keys not in both sets are copied or
+skipped), with a dedicated algorithm per container pair:
+  Array  ∩ Array  : merge walk (or binary search when sizes differ a lot)
+  Array  ∩ Bitmap : keep array values whose bit is set
+  Array  ∩ Run    : walk the array and the runs together
+  Bitmap ∩ Bitmap : word AND (AVX2), result back to Array if small
+  Run    ∩ Run    : interval intersection
+  Array  ∪ Array  : merge walk, Bitmap if the result passes 4096
+  Run    ∪ Run    : interval merge
+  anything else   : expand to a bitmap, word OR/AND, shrink if small
+
+Serialised format (portable: little-endian, fixed widths, 8-byte aligned
+payloads, so an mmap'd file is queried in place by MappedIntegerSet):
+  "RIS1" | u32 chunkCount | chunkCount x {u16 key, u8 type, u8 0,
+  u32 count, u32 payloadOffset} | payloads
+  type 1 Array : count values, u16 each
+  type 2 Bitmap: count = members, 1024 x u64
+  type 3 Run   : count runs, 2 x u16 each (start, length - 1)
+===============================================================================
+*/
+
+// little-endian load/store: the file format is the same on every machine
+inline void storeLE(uint8_t* p, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+}
+
+inline uint64_t loadLE(const uint8_t* p, int bytes) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t v = 0;
+    memcpy(&v, p, static_cast<size_t>(bytes));
+    return v;
+#else
+    uint64_t v = 0;
+    for (int i = bytes - 1; i >= 0; --i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+#endif
+}
+
+class CompressedIntegerSet {
+public:
+    enum ContainerType : uint8_t { Array = 1, Bitmap = 2, Run = 3 };
+
+    bool insertElement(uint32_t k) {
+        Container& c = containerFor(static_cast<uint16_t>(k >> 16));
+        bool inserted = c.insert(static_cast<uint16_t>(k));
+        return inserted;
+    }
+
+    bool deleteElement(uint32_t k) {
+        size_t i = findKey(static_cast<uint16_t>(k >> 16));
+        if (i == npos) {
+            return false;
+        }
+        bool erased = chunks[i].erase(static_cast<uint16_t>(k));
+        if (chunks[i].card == 0) {
+            chunks.erase(chunks.begin() + static_cast<ptrdiff_t>(i));
+        }
+        return erased;
+    }
+
+    bool hasElement(uint32_t k) const {
+        size_t i = findKey(static_cast<uint16_t>(k >> 16));
+        return i != npos && chunks[i].contains(static_cast<uint16_t>(k));
+    }
+
+    size_t cardinality() const {
+        size_t count = 0;
+        for (const Container& c : chunks) {
+            count += c.card;
+        }
+        return count;
+    }
+
+    // bytes of container payload (what the representation really costs)
+    size_t memoryBytes() const {
+        size_t bytes = chunks.size() * sizeof(Container);
+        for (const Container& c : chunks) {
+            bytes += c.values.size() * sizeof(uint16_t) + c.bits.size() * sizeof(uint64_t);
+        }
+        return bytes;
+    }
+
+    // Switch every chunk to the smallest of Array / Bitmap / Run
+    void runOptimize() {
+        for (Container& c : chunks) {
+            c.optimize();
+        }
+    }
+
+    bool isEqual(const CompressedIntegerSet& other) const {
+        if (chunks.size() != other.chunks.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            if (chunks[i].key != other.chunks[i].key || !chunks[i].sameMembers(other.chunks[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    CompressedIntegerSet unionOfIntegerSets(const CompressedIntegerSet& other) const {
+        CompressedIntegerSet result;
+        size_t i = 0, j = 0;
+        while (i < chunks.size() || j < other.chunks.size()) {
+            if (j == other.chunks.size() || (i < chunks.size() && chunks[i].key < other.chunks[j].key)) {
+                result.chunks.push_back(chunks[i++]);
+            } else if (i == chunks.size() || other.chunks[j].key < chunks[i].key) {
+                result.chunks.push_back(other.chunks[j++]);
+            } else {
+                result.chunks.push_back(Container::unite(chunks[i++], other.chunks[j++]));
             }
         }
+        return result;
+    }
+
+    CompressedIntegerSet intersectionOfIntegerSets(const CompressedIntegerSet& other) const {
+        CompressedIntegerSet result;
+        size_t i = 0, j = 0;
+        while (i < chunks.size() && j < other.chunks.size()) {
+            if (chunks[i].key < other.chunks[j].key) {
+                ++i;
+            } else if (other.chunks[j].key < chunks[i].key) {
+                ++j;
+            } else {
+                Container c = Container::intersect(chunks[i++], other.chunks[j++]);
+                if (c.card != 0) {
+                    result.chunks.push_back(std::move(c));
+                }
+            }
+        }
+        return result;
+    }
+
+    // Calls fn(value) for every member in increasing order
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (const Container& c : chunks) {
+            uint32_t high = static_cast<uint32_t>(c.key) << 16;
+            c.forEach([&](uint16_t low) { fn(high | low); });
+        }
+    }
+
+    void setPrint() const {
+        bool isEmpty = true;
+        forEach([&](uint32_t v) {
+            cout << v << " ";
+            isEmpty = false;
+        });
         if (isEmpty) {
             cout << "---";
         }
         cout << "\n";
     }
+
+    // container count per type, for reports
+    void containerCounts(size_t& arrays, size_t& bitmaps, size_t& runs) const {
+        arrays = bitmaps = runs = 0;
+        for (const Container& c : chunks) {
+            arrays += (c.type == Array) ? 1 : 0;
+            bitmaps += (c.type == Bitmap) ? 1 : 0;
+            runs += (c.type == Run) ? 1 : 0;
+        }
+    }
+
+    vector<uint8_t> serialize() const {
+        const size_t headerBytes = 8 + 12 * chunks.size();
+        size_t offset = (headerBytes + 7) & ~size_t(7);
+        vector<uint8_t> out(offset, 0);
+        memcpy(out.data(), "RIS1", 4);
+        storeLE(out.data() + 4, chunks.size(), 4);
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            const Container& c = chunks[i];
+            uint8_t* d = out.data() + 8 + 12 * i;
+            size_t count = (c.type == Run) ? c.values.size() / 2 : c.card;
+            storeLE(d, c.key, 2);
+            d[2] = c.type;
+            storeLE(d + 4, count, 4);
+            storeLE(d + 8, out.size(), 4);
+
+            size_t payload = (c.type == Bitmap) ? 8192 : c.values.size() * 2;
+            size_t start = out.size();
+            out.resize(start + ((payload + 7) & ~size_t(7)), 0);
+            if (c.type == Bitmap) {
+                for (size_t w = 0; w < 1024; ++w) storeLE(out.data() + start + 8 * w, c.bits[w], 8);
+            } else {
+                for (size_t v = 0; v < c.values.size(); ++v) storeLE(out.data() + start + 2 * v, c.values[v], 2);
+            }
+        }
+        return out;
+    }
+
+    // false if data is not a valid "RIS1" buffer (out is left unchanged)
+    static bool deserialize(const uint8_t* data, size_t size, CompressedIntegerSet& out);
+
+private:
+    struct Container {
+        uint16_t key = 0;
+        ContainerType type = Array;
+        uint32_t card = 0;
+        vector<uint16_t> values;   // Array: members; Run: start, length-1 pairs
+        vector<uint64_t> bits;     // Bitmap: 1024 words
+
+        bool contains(uint16_t low) const {
+            if (type == Bitmap) {
+                return (bits[low >> 6] >> (low & 63)) & 1;
+            }
+            if (type == Array) {
+                return binary_search(values.begin(), values.end(), low);
+            }
+            // last run starting at or before low
+            size_t lo = 0, hi = values.size() / 2;
+            while (lo < hi) {
+                size_t mid = (lo + hi) / 2;
+                if (values[2 * mid] <= low) lo = mid + 1;
+                else hi = mid;
+            }
+            return lo > 0 && low - values[2 * (lo - 1)] <= values[2 * (lo - 1) + 1];
+        }
+
+        bool insert(uint16_t low) {
+            if (type == Run) return insertRun(low);
+            if (type == Bitmap) {
+                uint64_t& w = bits[low >> 6];
+                uint64_t bit = uint64_t(1) << (low & 63);
+                if (w & bit) return false;
+                w |= bit;
+                ++card;
+                return true;
+            }
+            auto it = lower_bound(values.begin(), values.end(), low);
+            if (it != values.end() && *it == low) return false;
+            values.insert(it, low);
+            ++card;
+            if (card > 4096) toBitmap();
+            return true;
+        }
+
+        // Run: grow or join the neighbouring runs, else add a 1-value run
+        bool insertRun(uint16_t low) {
+            size_t runs = values.size() / 2;
+            size_t lo = 0, hi = runs;   // first run starting after low
+            while (lo < hi) {
+                size_t mid = (lo + hi) / 2;
+                if (values[2 * mid] <= low) lo = mid + 1;
+                else hi = mid;
+            }
+            bool joinsPrevious = false;
+            if (lo > 0) {
+                uint32_t previousEnd = uint32_t(values[2 * (lo - 1)]) + values[2 * (lo - 1) + 1];
+                if (low <= previousEnd) return false;
+                joinsPrevious = (low == previousEnd + 1);
+            }
+            bool joinsNext = lo < runs && uint32_t(low) + 1 == values[2 * lo];
+            if (joinsPrevious && joinsNext) {
+                values[2 * (lo - 1) + 1] = static_cast<uint16_t>(values[2 * (lo - 1) + 1] + values[2 * lo + 1] + 2);
+                values.erase(values.begin() + static_cast<ptrdiff_t>(2 * lo), values.begin() + static_cast<ptrdiff_t>(2 * lo + 2));
+            } else if (joinsPrevious) {
+                ++values[2 * (lo - 1) + 1];
+            } else if (joinsNext) {
+                --values[2 * lo];
+                ++values[2 * lo + 1];
+            } else {
+                values.insert(values.begin() + static_cast<ptrdiff_t>(2 * lo), {low, uint16_t(0)});
+            }
+            ++card;
+            // past 8 KB of runs a bitmap is smaller (like an array past 4096)
+            if (2 * values.size() > 8192) {
+                toBitmap();
+                shrinkBitmap();
+            }
+            return true;
+        }
+
+        bool erase(uint16_t low) {
+            if (type == Run) toBitmap();
+            if (type == Bitmap) {
+                uint64_t& w = bits[low >> 6];
+                uint64_t bit = uint64_t(1) << (low & 63);
+                if (!(w & bit)) return false;
+                w &= ~bit;
+                --card;
+                if (card <= 4096) shrinkBitmap();
+                return true;
+            }
+            auto it = lower_bound(values.begin(), values.end(), low);
+            if (it == values.end() || *it != low) return false;
+            values.erase(it);
+            --card;
+            return true;
+        }
+
+        template <typename Fn>
+        void forEach(Fn fn) const {
+            if (type == Array) {
+                for (uint16_t v : values) fn(v);
+            } else if (type == Bitmap) {
+                for (size_t i = 0; i < 1024; ++i) {
+                    for (uint64_t w = bits[i]; w != 0; w &= w - 1) {
+                        fn(static_cast<uint16_t>(i * 64 + static_cast<size_t>(__builtin_ctzll(w))));
+                    }
+                }
+            } else {
+                for (size_t r = 0; r < values.size(); r += 2) {
+                    for (uint32_t v = values[r]; v <= uint32_t(values[r]) + values[r + 1]; ++v) {
+                        fn(static_cast<uint16_t>(v));
+                    }
+                }
+            }
+        }
+
+        // members as 1024 words, whatever the container type
+        void fillBitmap(uint64_t* words) const {
+            if (type == Bitmap) {
+                memcpy(words, bits.data(), 8192);
+                return;
+            }
+            memset(words, 0, 8192);
+            if (type == Array) {
+                for (uint16_t v : values) words[v >> 6] |= uint64_t(1) << (v & 63);
+                return;
+            }
+            for (size_t r = 0; r < values.size(); r += 2) {
+                setRange(words, values[r], uint32_t(values[r]) + values[r + 1]);
+            }
+        }
+
+        static void setRange(uint64_t* words, uint32_t first, uint32_t last) {
+            size_t fw = first >> 6, lw = last >> 6;
+            uint64_t firstMask = ~uint64_t(0) << (first & 63);
+            uint64_t lastMask = ~uint64_t(0) >> (63 - (last & 63));
+            if (fw == lw) {
+                words[fw] |= firstMask & lastMask;
+                return;
+            }
+            words[fw] |= firstMask;
+            for (size_t w = fw + 1; w < lw; ++w) words[w] = ~uint64_t(0);
+            words[lw] |= lastMask;
+        }
+
+        void toBitmap() {
+            vector<uint64_t> words(1024);
+            fillBitmap(words.data());
+            bits.swap(words);
+            values.clear();
+            values.shrink_to_fit();
+            type = Bitmap;
+        }
+
+        // Bitmap -> Array once it is no bigger as an array
+        void shrinkBitmap() {
+            if (type != Bitmap || card > 4096) return;
+            vector<uint16_t> list;
+            list.reserve(card);
+            forEach([&](uint16_t v) { list.push_back(v); });
+            values.swap(list);
+            bits.clear();
+            bits.shrink_to_fit();
+            type = Array;
+        }
+
+        static Container fromBitmap(uint16_t key, vector<uint64_t>&& words) {
+            Container c;
+            c.key = key;
+            c.type = Bitmap;
+            c.bits = std::move(words);
+            for (uint64_t w : c.bits) c.card += static_cast<uint32_t>(__builtin_popcountll(w));
+            c.shrinkBitmap();
+            return c;
+        }
+
+        size_t countRuns() const {
+            if (type == Run) return values.size() / 2;
+            size_t runs = 0;
+            int64_t previous = -2;
+            forEach([&](uint16_t v) {
+                runs += (v != previous + 1) ? 1 : 0;
+                previous = v;
+            });
+            return runs;
+        }
+
+        void optimize() {
+            size_t runBytes = 4 * countRuns();
+            size_t plainBytes = (card > 4096) ? 8192 : 2 * size_t(card);
+            if (runBytes < plainBytes) {
+                if (type == Run) return;
+                vector<uint16_t> runs;
+                int64_t previous = -2;
+                forEach([&](uint16_t v) {
+                    if (v != previous + 1) {
+                        runs.push_back(v);
+                        runs.push_back(0);
+                    } else {
+                        ++runs.back();
+                    }
+                    previous = v;
+                });
+                values.swap(runs);
+                bits.clear();
+                bits.shrink_to_fit();
+                type = Run;
+            } else if (type == Run) {
+                toBitmap();
+                shrinkBitmap();
+            }
+        }
+
+        bool sameMembers(const Container& o) const {
+            if (card != o.card) return false;
+            if (type == o.type) {
+                return (type == Bitmap) ? bits == o.bits : values == o.values;
+            }
+            vector<uint64_t> a(1024), b(1024);
+            fillBitmap(a.data());
+            o.fillBitmap(b.data());
+            return a == b;
+        }
+
+        static Container fromRuns(uint16_t key, vector<uint16_t>&& runs) {
+            Container c;
+            c.key = key;
+            c.type = Run;
+            c.values = std::move(runs);
+            for (size_t r = 0; r < c.values.size(); r += 2) c.card += uint32_t(c.values[r + 1]) + 1;
+            return c;
+        }
+
+        static Container fromArray(uint16_t key, vector<uint16_t>&& list) {
+            Container c;
+            c.key = key;
+            c.card = static_cast<uint32_t>(list.size());
+            c.values = std::move(list);
+            if (c.card > 4096) c.toBitmap();
+            return c;
+        }
+
+        static void wordKernel(uint64_t* dst, const uint64_t* src, bool isAnd) {
+            size_t i = 0;
+#if defined(__AVX2__)
+            for (; i < 1024; i += 4) {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+                __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                                    isAnd ? _mm256_and_si256(x, y) : _mm256_or_si256(x, y));
+            }
+#endif
+            for (; i < 1024; ++i) dst[i] = isAnd ? (dst[i] & src[i]) : (dst[i] | src[i]);
+        }
+
+        static Container intersect(const Container& a, const Container& b) {
+            const uint16_t key = a.key;
+            if (a.type == Array && b.type == Array) {
+                const Container& small = (a.card <= b.card) ? a : b;
+                const Container& big = (a.card <= b.card) ? b : a;
+                vector<uint16_t> out;
+                if (big.card > 64 * small.card) {
+                    // very different sizes: binary search the small side's values
+                    for (uint16_t v : small.values) {
+                        if (binary_search(big.values.begin(), big.values.end(), v)) out.push_back(v);
+                    }
+                } else {
+                    set_intersection(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                                     back_inserter(out));
+                }
+                return fromArray(key, std::move(out));
+            }
+            if (a.type == Array || b.type == Array) {
+                // Array with Bitmap or Run: keep the array values the other side has
+                const Container& list = (a.type == Array) ? a : b;
+                const Container& other = (a.type == Array) ? b : a;
+                vector<uint16_t> out;
+                if (other.type == Bitmap) {
+                    for (uint16_t v : list.values) {
+                        if ((other.bits[v >> 6] >> (v & 63)) & 1) out.push_back(v);
+                    }
+                } else {
+                    size_t r = 0;
+                    for (uint16_t v : list.values) {
+                        while (r < other.values.size() && uint32_t(other.values[r]) + other.values[r + 1] < v) r += 2;
+                        if (r == other.values.size()) break;
+                        if (other.values[r] <= v) out.push_back(v);
+                    }
+                }
+                return fromArray(key, std::move(out));
+            }
+            if (a.type == Run && b.type == Run) {
+                vector<uint16_t> out;
+                size_t i = 0, j = 0;
+                while (i < a.values.size() && j < b.values.size()) {
+                    uint32_t aEnd = uint32_t(a.values[i]) + a.values[i + 1];
+                    uint32_t bEnd = uint32_t(b.values[j]) + b.values[j + 1];
+                    uint32_t start = max<uint32_t>(a.values[i], b.values[j]);
+                    uint32_t end = min(aEnd, bEnd);
+                    if (start <= end) {
+                        out.push_back(static_cast<uint16_t>(start));
+                        out.push_back(static_cast<uint16_t>(end - start));
+                    }
+                    if (aEnd < bEnd) i += 2;
+                    else j += 2;
+                }
+                return fromRuns(key, std::move(out));
+            }
+            // Bitmap with Bitmap or Run
+            vector<uint64_t> words(1024), other(1024);
+            a.fillBitmap(words.data());
+            b.fillBitmap(other.data());
+            wordKernel(words.data(), other.data(), true);
+            return fromBitmap(key, std::move(words));
+        }
+
+        static Container unite(const Container& a, const Container& b) {
+            const uint16_t key = a.key;
+            if (a.type == Array && b.type == Array) {
+                vector<uint16_t> out;
+                out.reserve(a.values.size() + b.values.size());
+                set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(), back_inserter(out));
+                return fromArray(key, std::move(out));
+            }
+            if (a.type == Run && b.type == Run) {
+                // both run lists are sorted: merge by start, fuse overlapping / touching runs
+                vector<uint16_t> out;
+                size_t i = 0, j = 0;
+                while (i < a.values.size() || j < b.values.size()) {
+                    const vector<uint16_t>* from;
+                    size_t* at;
+                    if (j == b.values.size() || (i < a.values.size() && a.values[i] <= b.values[j])) {
+                        from = &a.values;
+                        at = &i;
+                    } else {
+                        from = &b.values;
+                        at = &j;
+                    }
+                    uint32_t start = (*from)[*at];
+                    uint32_t end = start + (*from)[*at + 1];
+                    *at += 2;
+                    if (!out.empty()) {
+                        uint32_t lastEnd = uint32_t(out[out.size() - 2]) + out.back();
+                        if (start <= lastEnd + 1) {
+                            if (end > lastEnd) out.back() = static_cast<uint16_t>(end - out[out.size() - 2]);
+                            continue;
+                        }
+                    }
+                    out.push_back(static_cast<uint16_t>(start));
+                    out.push_back(static_cast<uint16_t>(end - start));
+                }
+                return fromRuns(key, std::move(out));
+            }
+            // at least one Bitmap, or Array with Run: OR as bitmaps
+            vector<uint64_t> words(1024), other(1024);
+            a.fillBitmap(words.data());
+            b.fillBitmap(other.data());
+            wordKernel(words.data(), other.data(), false);
+            return fromBitmap(key, std::move(words));
+        }
+    };
+
+    static constexpr size_t npos = ~size_t(0);
+    vector<Container> chunks;   // sorted by key, never empty containers
+
+    size_t findKey(uint16_t key) const {
+        auto it = lower_bound(chunks.begin(), chunks.end(), key,
+                              [](const Container& c, uint16_t k) { return c.key < k; });
+        return (it != chunks.end() && it->key == key) ? static_cast<size_t>(it - chunks.begin()) : npos;
+    }
+
+    Container& containerFor(uint16_t key) {
+        auto it = lower_bound(chunks.begin(), chunks.end(), key,
+                              [](const Container& c, uint16_t k) { return c.key < k; });
+        if (it == chunks.end() || it->key != key) {
+            Container c;
+            c.key = key;
+            it = chunks.insert(it, std::move(c));
+        }
+        return *it;
+    }
+
+    friend class MappedIntegerSet;
 };
 
-int main() {
+/*
+===============================================================================
+MappedIntegerSet: read-only view over a serialised "RIS1" buffer
+  - no copy and no parsing up front: point it at bytes (a vector, or a file
+    mapped with mmap) and hasElement() reads the containers in place
+  - open() validates the whole buffer once (it may come from any file):
+    header and payload bounds, keys strictly increasing, and each
+    container's contents, so nothing later can read or write out of range
+    Array : non-empty, values strictly increasing
+    Bitmap: count == popcount of the 1024 words, non-zero
+    Run   : non-empty, start + (length - 1) <= 65535, runs sorted and
+            disjoint
+===============================================================================
+*/
+class MappedIntegerSet {
+public:
+    bool open(const uint8_t* bytes, size_t bytesSize) {
+        data = nullptr;
+        if (bytesSize < 8 || memcmp(bytes, "RIS1", 4) != 0) return false;
+        size_t n = static_cast<size_t>(loadLE(bytes + 4, 4));
+        if (n > 65536 || 8 + 12 * n > bytesSize) return false;
+        uint32_t previousKey = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const uint8_t* d = bytes + 8 + 12 * i;
+            uint32_t key = static_cast<uint32_t>(loadLE(d, 2));
+            uint8_t type = d[2];
+            size_t count = static_cast<size_t>(loadLE(d + 4, 4));
+            size_t offset = static_cast<size_t>(loadLE(d + 8, 4));
+            size_t payload = (type == CompressedIntegerSet::Bitmap) ? 8192
+                           : (type == CompressedIntegerSet::Array) ? 2 * count
+                           : (type == CompressedIntegerSet::Run) ? 4 * count : SIZE_MAX;
+            if (payload == SIZE_MAX || offset > bytesSize || payload > bytesSize - offset ||
+                (i > 0 && key <= previousKey) || !validContents(type, count, bytes + offset)) {
+                return false;
+            }
+            previousKey = key;
+        }
+        data = bytes;
+        size = bytesSize;
+        chunkCount = n;
+        return true;
+    }
+
+    bool hasElement(uint32_t k) const {
+        if (data == nullptr) return false;
+        uint16_t key = static_cast<uint16_t>(k >> 16), low = static_cast<uint16_t>(k);
+        size_t lo = 0, hi = chunkCount;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            uint16_t midKey = static_cast<uint16_t>(loadLE(data + 8 + 12 * mid, 2));
+            if (midKey < key) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo == chunkCount || loadLE(data + 8 + 12 * lo, 2) != key) return false;
+        const uint8_t* d = data + 8 + 12 * lo;
+        size_t count = static_cast<size_t>(loadLE(d + 4, 4));
+        const uint8_t* p = data + loadLE(d + 8, 4);
+        if (d[2] == CompressedIntegerSet::Bitmap) {
+            return (loadLE(p + 8 * (low >> 6), 8) >> (low & 63)) & 1;
+        }
+        if (d[2] == CompressedIntegerSet::Array) {
+            size_t a = 0, b = count;
+            while (a < b) {
+                size_t mid = (a + b) / 2;
+                if (loadLE(p + 2 * mid, 2) < low) a = mid + 1;
+                else b = mid;
+            }
+            return a < count && loadLE(p + 2 * a, 2) == low;
+        }
+        size_t a = 0, b = count;   // Run: last run starting at or before low
+        while (a < b) {
+            size_t mid = (a + b) / 2;
+            if (loadLE(p + 4 * mid, 2) <= low) a = mid + 1;
+            else b = mid;
+        }
+        return a > 0 && low - loadLE(p + 4 * (a - 1), 2) <= loadLE(p + 4 * (a - 1) + 2, 2);
+    }
+
+    size_t cardinality() const {
+        size_t total = 0;
+        for (size_t i = 0; data != nullptr && i < chunkCount; ++i) {
+            const uint8_t* d = data + 8 + 12 * i;
+            size_t count = static_cast<size_t>(loadLE(d + 4, 4));
+            if (d[2] != CompressedIntegerSet::Run) {
+                total += count;
+                continue;
+            }
+            const uint8_t* p = data + loadLE(d + 8, 4);
+            for (size_t r = 0; r < count; ++r) total += static_cast<size_t>(loadLE(p + 4 * r + 2, 2)) + 1;
+        }
+        return total;
+    }
+
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    size_t chunkCount = 0;
+
+    // the container invariants CompressedIntegerSet relies on (bounds already checked)
+    static bool validContents(uint8_t type, size_t count, const uint8_t* p) {
+        if (type == CompressedIntegerSet::Bitmap) {
+            size_t members = 0;
+            for (size_t w = 0; w < 1024; ++w) members += static_cast<size_t>(__builtin_popcountll(loadLE(p + 8 * w, 8)));
+            return count != 0 && members == count;
+        }
+        if (count == 0) return false;
+        if (type == CompressedIntegerSet::Array) {
+            for (size_t v = 1; v < count; ++v) {
+                if (loadLE(p + 2 * v, 2) <= loadLE(p + 2 * (v - 1), 2)) return false;
+            }
+            return true;
+        }
+        int64_t previousEnd = -1;
+        for (size_t r = 0; r < count; ++r) {
+            int64_t start = static_cast<int64_t>(loadLE(p + 4 * r, 2));
+            int64_t end = start + static_cast<int64_t>(loadLE(p + 4 * r + 2, 2));
+            if (start <= previousEnd || end > 65535) return false;
+            previousEnd = end;
+        }
+        return true;
+    }
+};
+
+bool CompressedIntegerSet::deserialize(const uint8_t* data, size_t size, CompressedIntegerSet& out) {
+    MappedIntegerSet view;
+    if (!view.open(data, size)) return false;
+    CompressedIntegerSet result;
+    size_t n = static_cast<size_t>(loadLE(data + 4, 4));
+    for (size_t i = 0; i < n; ++i) {
+        const uint8_t* d = data + 8 + 12 * i;
+        size_t count = static_cast<size_t>(loadLE(d + 4, 4));
+        const uint8_t* p = data + loadLE(d + 8, 4);
+        Container c;
+        c.key = static_cast<uint16_t>(loadLE(d, 2));
+        c.type = static_cast<ContainerType>(d[2]);
+        if (c.type == Bitmap) {
+            c.bits.resize(1024);
+            for (size_t w = 0; w < 1024; ++w) c.bits[w] = loadLE(p + 8 * w, 8);
+            c.card = 0;
+            for (uint64_t w : c.bits) c.card += static_cast<uint32_t>(__builtin_popcountll(w));
+        } else {
+            size_t halfwords = (c.type == Run) ? 2 * count : count;
+            c.values.resize(halfwords);
+            for (size_t v = 0; v < halfwords; ++v) c.values[v] = static_cast<uint16_t>(loadLE(p + 2 * v, 2));
+            if (c.type == Array) {
+                c.card = static_cast<uint32_t>(count);
+            } else {
+                for (size_t r = 0; r < halfwords; r += 2) c.card += uint32_t(c.values[r + 1]) + 1;
+            }
+        }
+        if (c.card != 0) result.chunks.push_back(std::move(c));
+    }
+    out = std::move(result);
+    return true;
+}
+
+/*
+===============================================================================
+Benchmark (./a.out --bench): r = a | b | (c & d) over 0..10,000,000
+  - by value   : a.union(b).union(c.intersection(d)), 3 new sets per round
+  - into/in place: a.union(b, r); c.intersection(d, t); r |= t  (no
+                 allocation after the first round, still 3 passes)
+  - fused      : r = a | b | (c & d)  (one pass, no temporaries)
+===============================================================================
+*/
+int benchmarkSetExpressions() {
+    const int kMax = 10000000;
+    const int kRounds = 50;
+    mt19937 rng(45);
+    IntegerSet sets[4];
+    for (IntegerSet& s : sets) {
+        s = IntegerSet::withUniverse(kMax);
+        for (int i = 0; i < kMax / 4; ++i) s.insertElement(static_cast<int>(rng() % (kMax + 1)));
+    }
+    const IntegerSet& a = sets[0];
+    const IntegerSet& b = sets[1];
+    const IntegerSet& c = sets[2];
+    const IntegerSet& d = sets[3];
+
+    size_t checksum[3] = {0, 0, 0};
+    IntegerSet byValue;
+    auto t0 = chrono::steady_clock::now();
+    for (int round = 0; round < kRounds; ++round) {
+        byValue = a.unionOfIntegerSets(b).unionOfIntegerSets(c.intersectionOfIntegerSets(d));
+        checksum[0] += byValue.hasElement(round) ? 1 : 0;
+    }
+    auto t1 = chrono::steady_clock::now();
+    IntegerSet inPlace, scratch;
+    for (int round = 0; round < kRounds; ++round) {
+        a.unionOfIntegerSets(b, inPlace);
+        c.intersectionOfIntegerSets(d, scratch);
+        inPlace |= scratch;
+        checksum[1] += inPlace.hasElement(round) ? 1 : 0;
+    }
+    auto t2 = chrono::steady_clock::now();
+    IntegerSet fused;
+    for (int round = 0; round < kRounds; ++round) {
+        fused = a | b | (c & d);
+        checksum[2] += fused.hasElement(round) ? 1 : 0;
+    }
+    auto t3 = chrono::steady_clock::now();
+
+    bool same = byValue.isEqual(inPlace) && byValue.isEqual(fused) &&
+                checksum[0] == checksum[1] && checksum[0] == checksum[2];
+    auto perRound = [&](chrono::steady_clock::time_point from, chrono::steady_clock::time_point to) {
+        return chrono::duration<double, milli>(to - from).count() / kRounds;
+    };
+    cout << "a | b | (c & d) over 0.." << kMax << ", |result| = " << fused.cardinality() << "\n";
+    cout << "  by value      " << perRound(t0, t1) << " ms/round\n";
+    cout << "  into/in place " << perRound(t1, t2) << " ms/round\n";
+    cout << "  fused         " << perRound(t2, t3) << " ms/round\n";
+    cout << "  results match: " << (same ? "yes" : "NO") << "\n";
+    return same ? 0 : 1;
+}
+
+/*
+===============================================================================
+Benchmark (./a.out --bench): walking and ranking a set over 0..10,000,000
+  - walk   : iterator (one step per member) vs hasElement on every value
+  - rank   : 1M random rank(x) queries
+  - select : 1M random select(k) queries
+  Checked by select(i) == i-th member and rank(member) == i for every member.
+===============================================================================
+*/
+int benchmarkRankSelect() {
+    const int kMax = 10000000;
+    const int kQueries = 1000000;
+    mt19937 rng(46);
+    IntegerSet s = IntegerSet::withUniverse(kMax);
+    for (int i = 0; i < kMax / 20; ++i) s.insertElement(static_cast<int>(rng() % (kMax + 1)));
+
+    auto t0 = chrono::steady_clock::now();
+    uint64_t walked = 0;
+    for (int k : s) walked += static_cast<uint64_t>(k);
+    auto t1 = chrono::steady_clock::now();
+    uint64_t probed = 0;
+    for (int k = 0; k <= kMax; ++k) {
+        if (s.hasElement(k)) probed += static_cast<uint64_t>(k);
+    }
+    auto t2 = chrono::steady_clock::now();
+
+    vector<int> xs(kQueries);
+    vector<size_t> ks(kQueries);
+    size_t members = s.cardinality();
+    for (int q = 0; q < kQueries; ++q) {
+        xs[q] = static_cast<int>(rng() % (kMax + 1));
+        ks[q] = rng() % members;
+    }
+    s.insertElement(0);   // stale index: the first query below pays for the rebuild
+    members = s.cardinality();
+    auto t3 = chrono::steady_clock::now();
+    size_t rankSum = 0;
+    for (int x : xs) rankSum += s.rank(x);
+    auto t4 = chrono::steady_clock::now();
+    int64_t selectSum = 0;
+    for (size_t k : ks) selectSum += s.select(k);
+    auto t5 = chrono::steady_clock::now();
+
+    bool same = walked == probed;
+    size_t i = 0;
+    for (int k : s) {
+        same = same && s.select(i) == k && s.rank(k) == i;
+        ++i;
+    }
+    same = same && i == members && s.select(members) == -1 && s.rank(kMax + 1) == members;
+
+    auto ms = [](chrono::steady_clock::time_point from, chrono::steady_clock::time_point to) {
+        return chrono::duration<double, milli>(to - from).count();
+    };
+    cout << "rank/select over 0.." << kMax << ", " << members << " members (checksums "
+         << rankSum % 1000 << ", " << selectSum % 1000 << ")\n";
+    cout << "  walk    iterator " << ms(t0, t1) << " ms, hasElement loop " << ms(t1, t2) << " ms\n";
+    cout << "  rank    " << ms(t3, t4) * 1e6 / kQueries << " ns/query (incl. index rebuild)\n";
+    cout << "  select  " << ms(t4, t5) * 1e6 / kQueries << " ns/query\n";
+    cout << "  results match: " << (same ? "yes" : "NO") << "\n";
+    return same ? 0 : 1;
+}
+
+/*
+===============================================================================
+Benchmark (./a.out --bench): ConcurrentIntegerSet writer scaling
+  4M random inserts split over 1..64 writer threads, for
+  - wide: ids over 0..10,000,000 (threads rarely meet)
+  - hot : ids over 0..4095 (128 words: heavy false and true sharing)
+  and both paddings; each result is checked against a serial IntegerSet.
+  Then 4 writers keep moving ids between two sets while the main thread
+  takes unions: every union must still contain all 4 ids, and the writers
+  must keep moving while it does.
+===============================================================================
+*/
+int benchmarkConcurrent() {
+    const int kMax = 10000000;
+    const int kOps = 1 << 22;
+    const int threadCounts[] = {1, 2, 4, 8, 16, 32, 64};
+    auto nextId = [](uint64_t& state, int range) {
+        state ^= state << 13;   // xorshift64: cheap per-thread stream
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<int>(state % static_cast<uint64_t>(range + 1));
+    };
+
+    bool ok = true;
+    const char* rangeNames[2] = {"wide", "hot "};
+    const int ranges[2] = {kMax, 4095};
+    for (int r = 0; r < 2; ++r) {
+        for (int pad = 0; pad < 2; ++pad) {
+            ConcurrentIntegerSet::Padding padding =
+                (pad == 0) ? ConcurrentIntegerSet::Padding::Packed : ConcurrentIntegerSet::Padding::PerWord;
+            cout << rangeNames[r] << (pad == 0 ? " packed  " : " per-word") << " Mops/s:";
+            for (int threads : threadCounts) {
+                ConcurrentIntegerSet set(kMax, padding);
+                int perThread = kOps / threads;
+                auto t0 = chrono::steady_clock::now();
+                vector<thread> writers;
+                for (int t = 0; t < threads; ++t) {
+                    writers.emplace_back([&, t]() {
+                        uint64_t state = 0x9E3779B97F4A7C15ULL * static_cast<uint64_t>(t + 1);
+                        for (int i = 0; i < perThread; ++i) set.insertElement(nextId(state, ranges[r]));
+                    });
+                }
+                for (thread& w : writers) w.join();
+                auto t1 = chrono::steady_clock::now();
+
+                IntegerSet expected = IntegerSet::withUniverse(kMax);
+                for (int t = 0; t < threads; ++t) {
+                    uint64_t state = 0x9E3779B97F4A7C15ULL * static_cast<uint64_t>(t + 1);
+                    for (int i = 0; i < perThread; ++i) expected.insertElement(nextId(state, ranges[r]));
+                }
+                ok = ok && set.snapshot().set->isEqual(expected);
+                double seconds = chrono::duration<double>(t1 - t0).count();
+                cout << " " << threads << "t " << static_cast<double>(perThread) * threads / seconds / 1e6;
+            }
+            cout << "\n";
+        }
+    }
+
+    // ids move A -> B -> A; insert-before-delete keeps each id in A u B at
+    // every instant, which only a same-instant pair of copies can show
+    ConcurrentIntegerSet a(kMax), b(kMax);
+    const int kMovers = 4;
+    for (int t = 0; t < kMovers; ++t) a.insertElement(t * (kMax / kMovers));
+    atomic<bool> stop(false);
+    atomic<uint64_t> moves(0);
+    vector<thread> movers;
+    for (int t = 0; t < kMovers; ++t) {
+        movers.emplace_back([&, t]() {
+            int id = t * (kMax / kMovers);
+            uint64_t mine = 0;
+            while (!stop.load(memory_order_relaxed)) {
+                b.insertElement(id);
+                a.deleteElement(id);
+                a.insertElement(id);
+                b.deleteElement(id);
+                ++mine;
+            }
+            moves.fetch_add(mine);
+        });
+    }
+    int unions = 0;
+    bool consistent = true;
+    auto t0 = chrono::steady_clock::now();
+    for (; unions < 200; ++unions) {
+        IntegerSet both = a.unionOfIntegerSets(b);
+        for (int t = 0; t < kMovers; ++t) consistent = consistent && both.hasElement(t * (kMax / kMovers));
+    }
+    auto t1 = chrono::steady_clock::now();
+    stop.store(true);
+    for (thread& m : movers) m.join();
+    ok = ok && consistent;
+    double elapsedMs = chrono::duration<double, milli>(t1 - t0).count();
+    cout << "snapshot unions under " << kMovers << " writers: " << unions << " unions, " << elapsedMs / unions
+         << " ms each, writers meanwhile " << static_cast<double>(moves.load()) / elapsedMs
+         << " moves/ms (never blocked), ids never lost: " << (consistent ? "yes" : "NO") << "\n";
+    cout << "  results match: " << (ok ? "yes" : "NO") << "\n";
+    return ok ? 0 : 1;
+}
+
+/*
+===============================================================================
+Benchmark (./a.out --bench): compressed vs dense bitset on id-like sets
+  universe 0..2^28 (dense IntegerSet = 32 MB per set)
+  - sparse   : 200k random user ids
+  - clustered: ranges of consecutive ids (batch imports / sessions)
+  - dense    : half of the ids below 2^22 (a hot range)
+  For each shape: memory, serialised size, and union + intersection time.
+===============================================================================
+*/
+int benchmarkCompressed() {
+    const int kMax = (1 << 28) - 1;
+    mt19937 rng(44);
+    auto makeShape = [&](int shape, IntegerSet& dense, CompressedIntegerSet& compressed) {
+        dense = IntegerSet::withUniverse(kMax);
+        compressed = CompressedIntegerSet();
+        auto add = [&](uint32_t v) {
+            dense.insertElement(static_cast<int>(v));
+            compressed.insertElement(v);
+        };
+        if (shape == 0) {
+            for (int i = 0; i < 200000; ++i) add(rng() & static_cast<uint32_t>(kMax));
+        } else if (shape == 1) {
+            for (int r = 0; r < 300; ++r) {
+                uint32_t start = rng() & static_cast<uint32_t>(kMax);
+                uint32_t length = 1 + rng() % 20000;
+                for (uint32_t v = start; v < start + length && v <= static_cast<uint32_t>(kMax); ++v) add(v);
+            }
+        } else {
+            for (uint32_t v = 0; v < (1U << 22); ++v) {
+                if (rng() & 1) add(v);
+            }
+        }
+        compressed.runOptimize();
+    };
+
+    const char* names[3] = {"sparse", "clustered", "dense"};
+    bool ok = true;
+    for (int shape = 0; shape < 3; ++shape) {
+        IntegerSet denseA, denseB;
+        CompressedIntegerSet a, b;
+        makeShape(shape, denseA, a);
+        makeShape(shape, denseB, b);
+
+        auto t0 = chrono::steady_clock::now();
+        IntegerSet denseUnion = denseA.unionOfIntegerSets(denseB);
+        IntegerSet denseBoth = denseA.intersectionOfIntegerSets(denseB);
+        auto t1 = chrono::steady_clock::now();
+        CompressedIntegerSet unionSet = a.unionOfIntegerSets(b);
+        CompressedIntegerSet both = a.intersectionOfIntegerSets(b);
+        auto t2 = chrono::steady_clock::now();
+
+        vector<uint8_t> bytes = a.serialize();
+        MappedIntegerSet view;
+        CompressedIntegerSet loaded;
+        bool same = unionSet.cardinality() == denseUnion.cardinality() &&
+                    both.cardinality() == denseBoth.cardinality() &&
+                    view.open(bytes.data(), bytes.size()) && view.cardinality() == a.cardinality() &&
+                    CompressedIntegerSet::deserialize(bytes.data(), bytes.size(), loaded) && loaded.isEqual(a);
+        for (int probe = 0; probe < 10000 && same; ++probe) {
+            uint32_t v = rng() & static_cast<uint32_t>(kMax);
+            same = view.hasElement(v) == denseA.hasElement(static_cast<int>(v)) &&
+                   a.hasElement(v) == denseA.hasElement(static_cast<int>(v));
+        }
+        ok = ok && same;
+
+        size_t arrays, bitmaps, runs;
+        a.containerCounts(arrays, bitmaps, runs);
+        cout << names[shape] << ": " << a.cardinality() << " members, containers "
+             << arrays << " array / " << bitmaps << " bitmap / " << runs << " run\n";
+        cout << "  memory      dense " << ((static_cast<size_t>(kMax) + 1) / 8 / 1024) << " KB, compressed "
+             << a.memoryBytes() / 1024 << " KB, serialised " << bytes.size() / 1024 << " KB\n";
+        cout << "  union+inter dense " << chrono::duration<double, milli>(t1 - t0).count()
+             << " ms, compressed " << chrono::duration<double, milli>(t2 - t1).count() << " ms\n";
+        cout << "  results match: " << (same ? "yes" : "NO") << "\n";
+    }
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        int status = benchmarkSetExpressions();
+        status |= benchmarkRankSelect();
+        status |= benchmarkConcurrent();
+        return benchmarkCompressed() | status;
+    }
+
     // 1) Empty set test
     IntegerSet set1;
     cout << "Set 1 (empty): ";
@@ -166,5 +1856,109 @@ int main() {
     cout << "Set2 == Set4 ? " << (set2.isEqual(set4) ? "true" : "false") << "\n"; // expect true
     cout << "Set2 == Set3 ? " << (set2.isEqual(set3) ? "true" : "false") << "\n"; // expect false
 
+    // 6) Difference / symmetric difference
+    cout << "\nDifference tests:\n";
+    IntegerSet set5(1, 2, 3, 4, 5);
+    cout << "Set 5: ";
+    set5.setPrint();
+    cout << "Set5 - Set2: ";
+    set5.differenceOfIntegerSets(set2).setPrint(); // expect 2 4
+    cout << "Set5 xor Set2: ";
+    set5.symmetricDifferenceOfIntegerSets(set2).setPrint(); // expect 2 4 7 9
+    cout << "|Set5 xor Set2| = " << set5.symmetricDifferenceOfIntegerSets(set2).cardinality() << "\n"; // expect 4
+
+    // 7) Large universe: 0..10,000,000 (1.25 MB per set instead of 10 MB of bools)
+    cout << "\nLarge universe tests:\n";
+    const int kMax = 10000000;
+    IntegerSet evens = IntegerSet::withUniverse(kMax);
+    IntegerSet multiplesOf3 = IntegerSet::withUniverse(kMax);
+    for (int i = 0; i <= kMax; i += 2) evens.insertElement(i);
+    for (int i = 0; i <= kMax; i += 3) multiplesOf3.insertElement(i);
+
+    auto t0 = chrono::steady_clock::now();
+    IntegerSet both = evens.intersectionOfIntegerSets(multiplesOf3);
+    IntegerSet either = evens.unionOfIntegerSets(multiplesOf3);
+    auto t1 = chrono::steady_clock::now();
+    cout << "|evens| = " << evens.cardinality() << ", |multiples of 3| = " << multiplesOf3.cardinality() << "\n";
+    cout << "|evens AND multiples of 3| = " << both.cardinality() << "\n";    // expect 1666667
+    cout << "|evens OR multiples of 3|  = " << either.cardinality() << "\n";  // expect 6666668
+    cout << "union + intersection took "
+         << chrono::duration<double, micro>(t1 - t0).count() << " us\n";
+    cout << "Set 2 == Set 2 copied into the large universe ? "
+         << (set2.isEqual(IntegerSet::withUniverse(kMax).unionOfIntegerSets(set2)) ? "true" : "false")
+         << "\n"; // expect true (mixed universes compare by members)
+
+    // 8) In-place, into-destination and fused chains
+    cout << "\nIn-place / expression tests:\n";
+    IntegerSet acc(1, 2, 3);
+    acc |= set3;
+    cout << "{1 2 3} |= Set 3: ";
+    acc.setPrint(); // expect 1 2 3 4 6 8 10
+    acc &= set2 | set5;
+    cout << "&= (Set 2 | Set 5): ";
+    acc.setPrint(); // expect 1 2 3 4
+    acc -= set2;
+    cout << "-= Set 2: ";
+    acc.setPrint(); // expect 2 4
+    IntegerSet chain = set2 | ((set3 - set5) ^ (set4 & set5));
+    cout << "Set2 | ((Set3 - Set5) ^ (Set4 & Set5)): ";
+    chain.setPrint(); // expect 1 3 5 6 7 8 9 10
+    IntegerSet reused;
+    evens.intersectionOfIntegerSets(multiplesOf3, reused);
+    reused |= either - both;
+    cout << "reused == evens | multiples of 3 ? " << (reused.isEqual(either) ? "true" : "false") << "\n"; // expect true
+
+    // 9) Ordered walk and rank/select
+    cout << "\nRank/select tests:\n";
+    cout << "Set 2 via iterator:";
+    for (int k : set2) cout << " " << k;
+    cout << "\n"; // expect 1 3 5 7 9
+    cout << "evens: rank(10) = " << evens.rank(10) << ", select(5) = " << evens.select(5)
+         << ", select(1000000) = " << evens.select(1000000) << "\n"; // expect 5, 10, 2000000
+    evens.insertElement(1);
+    cout << "after inserting 1: rank(10) = " << evens.rank(10) << ", select(1) = " << evens.select(1) << "\n"; // expect 6, 1
+    evens.deleteElement(1);
+    cout << "rank(" << kMax << ") = " << evens.rank(kMax) << ", select(|evens|) = "
+         << evens.select(evens.cardinality()) << "\n"; // expect 5000000, -1
+
+    // 10) Concurrent set: 4 threads insert disjoint ids, then a consistent copy
+    cout << "\nConcurrent set tests:\n";
+    ConcurrentIntegerSet shared(kMax);
+    vector<thread> producers;
+    for (int t = 0; t < 4; ++t) {
+        producers.emplace_back([&shared, t]() {
+            for (int i = t; i < 1000000; i += 4) shared.insertElement(i);
+        });
+    }
+    for (thread& producer : producers) producer.join();
+    ConcurrentIntegerSet::Snapshot first = shared.snapshot();
+    ConcurrentIntegerSet::Snapshot second = shared.snapshot();
+    cout << "|shared| = " << first.set->cardinality() << ", second snapshot reuses the copy ? "
+         << (first.set == second.set ? "true" : "false") << "\n"; // expect 1000000, true
+    shared.deleteElement(0);
+    cout << "after a delete: epoch changed ? " << (shared.snapshot().epoch != first.epoch ? "true" : "false")
+         << ", |shared AND evens| = " << shared.snapshot().set->intersectionOfIntegerSets(evens).cardinality() << "\n"; // expect true, 499999
+
+    // 11) Compressed (Roaring-style) set: same API, memory follows the members
+    cout << "\nCompressed set tests:\n";
+    CompressedIntegerSet ids;
+    for (uint32_t v = 4000000000U; v < 4000100000U; ++v) ids.insertElement(v);   // one long range
+    ids.insertElement(7);
+    ids.insertElement(70000);
+    CompressedIntegerSet few;
+    few.insertElement(7);
+    few.insertElement(4000000123U);
+    few.insertElement(123456);
+    cout << "|ids| = " << ids.cardinality() << ", " << ids.memoryBytes() << " bytes";
+    ids.runOptimize();
+    cout << " -> " << ids.memoryBytes() << " bytes after runOptimize\n";
+    cout << "ids AND few: ";
+    ids.intersectionOfIntegerSets(few).setPrint(); // expect 7 4000000123
+    cout << "|ids OR few| = " << ids.unionOfIntegerSets(few).cardinality() << "\n"; // expect 100003
+    vector<uint8_t> bytes = ids.serialize();
+    MappedIntegerSet view;
+    cout << "serialised " << bytes.size() << " bytes, view ok = " << (view.open(bytes.data(), bytes.size()) ? "true" : "false")
+         << ", view has 4000054321 ? " << (view.hasElement(4000054321U) ? "true" : "false") << "\n"; // expect true
+
     return 0;
 }